@@ -20,9 +20,22 @@
 
 #include <fstream>
 #include <string>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <type_traits>
+#include <utility>
 
 #include <seqan/index.h>
 #include <sdsl/suffix_arrays.hpp>
+#include <sdsl/construct.hpp>
+#ifdef PSI_USE_LIBSAIS
+#include <libsais64.h>
+#endif  /* ----- #ifdef PSI_USE_LIBSAIS  ----- */
 
 #include "sequence.hpp"
 #include "utils.hpp"
@@ -32,6 +45,16 @@ namespace psi {
   template< class TWT = sdsl::wt_huff<>, uint32_t TDens = 32, uint32_t TInvDens = 64 >
     struct FMIndex;
 
+  /* Sampling profiles  ---------------------------------------------------------- */
+
+  /**
+   *  Locating an occurrence takes at most `TDens - 1` LF steps while the SA samples
+   *  occupy `n / TDens * log(n)` bits; the ISA samples (`TInvDens`) are only used for
+   *  extracting the text. `FMIndex<>` is the default profile.
+   */
+  typedef FMIndex< sdsl::wt_huff<>, 8, 64 > FastFMIndex;       /**< @brief Faster locate, larger index. */
+  typedef FMIndex< sdsl::wt_huff<>, 128, 256 > CompactFMIndex; /**< @brief Smaller index, slower locate. */
+
   template< typename TSpec >
     class is_fmindex : public std::false_type {
     };
@@ -39,6 +62,493 @@ namespace psi {
   template< class TWT, uint32_t TDens, uint32_t TInvDens >
     class is_fmindex< FMIndex< TWT, TDens, TInvDens > > : public std::true_type {
     };
+
+  /**
+   *  @brief  Check whether the top level bits of the wavelet tree of a CSA is exposed.
+   *
+   *  The wavelet trees of `wt_pc` family (e.g. `wt_huff`) store all levels in one
+   *  bit vector `bv` whose first `n` bits are the root level.
+   */
+  template< typename TCSA, typename = void >
+    class has_wt_bits : public std::false_type {
+    };
+
+  template< typename TCSA >
+    class has_wt_bits< TCSA, std::void_t< decltype( std::declval< TCSA const& >().wavelet_tree.bv.data() ) > >
+    : public std::true_type {
+    };
+
+  /**
+   *  @brief  Q-gram lookup table of an FM index.
+   *
+   *  It maps each DNA q-gram to the SA range obtained by backward searching its
+   *  characters in order (i.e. by going down the iterator from the root along the
+   *  q-gram). So, a search can jump to depth `q` directly instead of paying `q`
+   *  backward search steps. A q-gram is encoded by packing its characters in 2 bits
+   *  each, the first character in the most significant bits (see `PackedKmer`).
+   *
+   *  The ranges are stored as half-open intervals `[lo, hi)` in a bit-compressed
+   *  vector; so the table occupies `2 * 4^q * log(n)` bits.
+   */
+  class QGramTable {
+    public:
+      /* ====================  TYPEDEFS      ======================================= */
+      typedef uint64_t size_type;
+      typedef uint64_t code_type;
+      typedef std::pair< size_type, size_type > range_type;
+      /* ====================  CONSTANTS     ======================================= */
+      constexpr static const unsigned int MAX_Q = 16;
+      /* ====================  LIFECYCLE     ======================================= */
+      QGramTable( ) : q( 0 ) { }
+      /* ====================  ACCESSORS     ======================================= */
+        inline unsigned int
+      get_q( ) const
+      {
+        return this->q;
+      }
+
+        inline sdsl::int_vector<> const&
+      get_bounds( ) const
+      {
+        return this->bounds;
+      }
+      /* ====================  METHODS       ======================================= */
+        inline bool
+      empty( ) const
+      {
+        return this->q == 0;
+      }
+
+        inline void
+      clear( )
+      {
+        this->q = 0;
+        sdsl::util::clear( this->bounds );
+      }
+
+      /**
+       *  @brief  Build the table for the given FM index.
+       *
+       *  @param  fm The FM index.
+       *  @param  qlen The length of the q-grams.
+       *  @param  nof_threads The number of threads.
+       *
+       *  All q-grams are enumerated depth-first by backward search pruning the empty
+       *  ranges. In multi-threaded mode, the subtrees rooted at short prefixes are
+       *  distributed among threads. The prefix length is chosen such that each subtree
+       *  fills at least 64 consecutive entries of the table, i.e. a whole number of
+       *  words in the bit-compressed vector; so no two threads write to the same word.
+       */
+      template< typename TCSA >
+          inline void
+        build( TCSA const& fm, unsigned int qlen, unsigned int nof_threads=1 )
+        {
+          if ( qlen > MAX_Q ) {
+            throw std::runtime_error( "q-gram length should not be larger than " +
+                                      std::to_string( MAX_Q ) );
+          }
+          this->clear();
+          if ( qlen == 0 || fm.size() == 0 ) return;
+
+          this->q = qlen;
+          sdsl::int_vector<> b( 2 * ( code_type( 1 ) << ( 2 * qlen ) ), 0,
+                                sdsl::bits::hi( fm.size() ) + 1 );
+
+          unsigned int plen = 0;
+          while ( nof_threads > 1 && plen < 2 && qlen - plen > 3 &&
+                  ( code_type( 1 ) << ( 2 * plen ) ) < nof_threads ) {
+            ++plen;
+          }
+
+          if ( plen == 0 ) {
+            QGramTable::fill( fm, b, qlen, { 0, 0, 0, fm.size() - 1 } );
+          }
+          else {
+            std::vector< Frame > tasks;
+            QGramTable::fill( fm, tasks, plen, { 0, 0, 0, fm.size() - 1 } );
+            std::atomic< std::size_t > next( 0 );
+            std::exception_ptr eptr = nullptr;
+            std::mutex eptr_m;
+            auto worker = [&]( ) {
+              try {
+                std::size_t i;
+                while ( ( i = next.fetch_add( 1 ) ) < tasks.size() ) {
+                  QGramTable::fill( fm, b, qlen, tasks[ i ] );
+                }
+              }
+              catch ( ... ) {
+                std::lock_guard< std::mutex > lock( eptr_m );
+                if ( !eptr ) eptr = std::current_exception();
+              }
+            };
+            std::vector< std::thread > threads;
+            for ( unsigned int t = 1; t < nof_threads; ++t ) threads.emplace_back( worker );
+            worker();
+            for ( auto& t : threads ) t.join();
+            if ( eptr ) std::rethrow_exception( eptr );
+          }
+          this->bounds = std::move( b );
+        }
+
+      /**
+       *  @brief  Get the SA range of a q-gram.
+       *
+       *  @param  code The packed q-gram.
+       *  @return The closed SA range; it is empty (i.e. `first > second`) if the q-gram
+       *          does not occur.
+       */
+        inline range_type
+      range( code_type code ) const
+      {
+        assert( !this->empty() && code < ( code_type( 1 ) << ( 2 * this->q ) ) );
+        size_type lo = this->bounds[ 2 * code ];
+        size_type hi = this->bounds[ 2 * code + 1 ];
+        if ( lo == hi ) return range_type( 1, 0 );
+        return range_type( lo, hi - 1 );
+      }
+
+        inline void
+      serialize( std::ostream& out ) const
+      {
+        psi::serialize( out, static_cast< uint64_t >( this->q ) );
+        this->bounds.serialize( out );
+      }
+
+        inline void
+      load( std::istream& in )
+      {
+        uint64_t qlen;
+        psi::deserialize( in, qlen );
+        if ( qlen > MAX_Q ) throw std::runtime_error( "corrupted q-gram table" );
+        this->q = qlen;
+        this->bounds.load( in );
+      }
+    private:
+      /* ====================  TYPEDEFS      ======================================= */
+      struct Frame { code_type code; unsigned int depth; size_type lo; size_type hi; };
+      /* ====================  DATA MEMBERS  ======================================= */
+      unsigned int q;
+      sdsl::int_vector<> bounds;
+      /* ====================  METHODS       ======================================= */
+      /**
+       *  @brief  Enumerate all q-grams below a node by backward search.
+       *
+       *  @param  fm The FM index.
+       *  @param  out The output; either the table or a vector of frames.
+       *  @param  qlen The depth at which the nodes are reported.
+       *  @param  root The root of the enumeration.
+       */
+      template< typename TCSA, typename TOutput >
+          static inline void
+        fill( TCSA const& fm, TOutput& out, unsigned int qlen, Frame root )
+        {
+          static const char alphabet[] = { 'A', 'C', 'G', 'T' };
+
+          std::vector< Frame > stack;
+          stack.push_back( root );
+          while ( !stack.empty() ) {
+            Frame f = stack.back();
+            stack.pop_back();
+            if ( f.depth == qlen ) {
+              QGramTable::report( out, f );
+              continue;
+            }
+            for ( code_type c = 0; c < 4; ++c ) {
+              size_type lo = 0;
+              size_type hi = 0;
+              if ( sdsl::backward_search( fm, f.lo, f.hi, alphabet[ c ], lo, hi ) == 0 ) continue;
+              stack.push_back( { ( f.code << 2 ) | c, f.depth + 1, lo, hi } );
+            }
+          }
+        }
+
+        static inline void
+      report( sdsl::int_vector<>& b, Frame const& f )
+      {
+        b[ 2 * f.code ] = f.lo;
+        b[ 2 * f.code + 1 ] = f.hi + 1;
+      }
+
+        static inline void
+      report( std::vector< Frame >& frames, Frame const& f )
+      {
+        frames.push_back( f );
+      }
+  };  /* --- end of class QGramTable --- */
+
+  /**
+   *  @brief  Check whether the wavelet tree nodes and SA samples of a CSA are exposed.
+   *
+   *  The `wt_pc` family of wavelet trees provides node-wise traversal (`root`,
+   *  `expand`, `bit_vec`, and `sym`) which allows computing LF of a range of rows at
+   *  once (see `locate`).
+   */
+  template< typename TCSA, typename = void >
+    class has_wt_nodes : public std::false_type {
+    };
+
+  template< typename TCSA >
+    class has_wt_nodes< TCSA, std::void_t<
+      decltype( std::declval< TCSA const& >().wavelet_tree.bit_vec(
+                  std::declval< TCSA const& >().wavelet_tree.root() ) ),
+      decltype( std::declval< TCSA const& >().sa_sample.is_sampled( 0 ) ) > >
+    : public std::true_type {
+    };
+
+  /**
+   *  @brief  Scratch memory of batched locate.
+   *
+   *  It holds the working buffers of `locate`; reusing one instance across calls
+   *  avoids allocations once the buffers have grown to the largest SA range.
+   */
+  class LocateScratch {
+    public:
+      /* ====================  TYPEDEFS      ======================================= */
+      typedef uint64_t size_type;
+      /**
+       *  @brief  Rows `[lb, lb+len)` whose output slots are `ids[begin, begin+len)`.
+       */
+      struct Block { size_type lb; size_type begin; size_type len; };
+      /* ====================  CONSTANTS     ======================================= */
+      constexpr static const size_type npos = std::numeric_limits< size_type >::max();
+      /* ====================  DATA MEMBERS  ======================================= */
+      std::vector< Block > blocks;
+      std::vector< Block > next_blocks;
+      std::vector< size_type > ids;
+      std::vector< size_type > next_ids;
+      std::vector< std::vector< size_type > > levels;  /**< @brief Per wavelet tree level. */
+      std::vector< size_type > positions;               /**< @brief Located positions. */
+      /* ====================  METHODS       ======================================= */
+        inline size_type*
+      level( unsigned int l, size_type len )
+      {
+        if ( l >= this->levels.size() ) this->levels.resize( l + 1 );
+        if ( this->levels[ l ].size() < len ) this->levels[ l ].resize( len );
+        return this->levels[ l ].data();
+      }
+
+      /**
+       *  @brief  Get the scratch memory of the calling thread.
+       */
+        static inline LocateScratch&
+      get( )
+      {
+        thread_local static LocateScratch scratch;
+        return scratch;
+      }
+  };  /* --- end of class LocateScratch --- */
+
+  /**
+   *  @brief  Compute LF of a block of rows by traversing the wavelet tree once.
+   *
+   *  @param  fm The FM index.
+   *  @param  v The current wavelet tree node.
+   *  @param  r The closed range of the block in the node sequence.
+   *  @param  ids The output slots of the rows in the block in order.
+   *  @param  scratch The scratch memory; the resulting blocks are appended to
+   *                  `next_blocks` and `next_ids`.
+   *  @param  depth The depth of the node `v`.
+   *
+   *  The rows of the block having the same BWT character are mapped by LF to
+   *  consecutive rows. So, the ranks are computed once per visited node while the
+   *  rows are only partitioned by their bits at each level.
+   */
+  template< typename TCSA, typename TNode, typename TRange >
+      inline void
+    _lf_block( TCSA const& fm, TNode const& v, TRange const& r,
+        LocateScratch::size_type const* ids, LocateScratch& scratch, unsigned int depth=0 )
+    {
+      typedef LocateScratch::size_type size_type;
+
+      auto const& wt = fm.wavelet_tree;
+      size_type len = r[1] + 1 - r[0];
+      if ( wt.is_leaf( v ) ) {
+        size_type lb = fm.C[ fm.char2comp[ wt.sym( v ) ] ] + r[0];
+        scratch.next_blocks.push_back( { lb, scratch.next_ids.size(), len } );
+        scratch.next_ids.insert( scratch.next_ids.end(), ids, ids + len );
+        return;
+      }
+
+      auto children = wt.expand( v );
+      auto ranges = wt.expand( v, r );
+      auto bits = wt.bit_vec( v );
+      size_type nz = ranges[0][1] + 1 - ranges[0][0];
+      size_type* buf = scratch.level( depth, len );
+      size_type i0 = 0;
+      size_type i1 = nz;
+      for ( size_type j = 0; j < len; ++j ) {
+        if ( bits[ r[0] + j ] ) buf[ i1++ ] = ids[ j ];
+        else buf[ i0++ ] = ids[ j ];
+      }
+      /* NOTE: `buf` remains valid even if deeper levels grow the scratch. */
+      if ( nz != 0 ) _lf_block( fm, children[0], ranges[0], buf, scratch, depth + 1 );
+      if ( nz != len ) _lf_block( fm, children[1], ranges[1], buf + nz, scratch, depth + 1 );
+    }
+
+  /**
+   *  @brief  Locate the SA values of a range of rows independently.
+   */
+  template< typename TCSA >
+      inline void
+    _locate( TCSA const& fm, uint64_t lb, uint64_t rb, uint64_t* out, LocateScratch&,
+        std::false_type )
+    {
+      for ( uint64_t i = lb; i <= rb; ++i ) *out++ = fm[ i ];
+    }
+
+  /**
+   *  @brief  Locate the SA values of a range of rows by walking them in lockstep.
+   *
+   *  All rows walk LF one step at a time until they reach a sampled row. The rows
+   *  are kept in blocks of consecutive rows (possibly with holes of resolved rows);
+   *  each block is advanced by one traversal of the wavelet tree. Sparse or small
+   *  blocks fall back to locating their rows independently.
+   */
+  template< typename TCSA >
+      inline void
+    _locate( TCSA const& fm, uint64_t lb, uint64_t rb, uint64_t* out, LocateScratch& scratch,
+        std::true_type )
+    {
+      typedef LocateScratch::size_type size_type;
+
+      /* Minimum number of unresolved rows in a block for walking them in lockstep. */
+      constexpr static const size_type MIN_BLOCK_ROWS = 8;
+      constexpr static const size_type npos = LocateScratch::npos;
+
+      size_type n = fm.size();
+      auto wrap = [n]( size_type pos ) { return pos < n ? pos : pos - n; };
+
+      scratch.blocks.clear();
+      scratch.ids.clear();
+      for ( size_type j = 0; j <= rb - lb; ++j ) scratch.ids.push_back( j );
+      scratch.blocks.push_back( { lb, 0, rb - lb + 1 } );
+
+      for ( size_type off = 0; !scratch.blocks.empty(); ++off ) {
+        scratch.next_blocks.clear();
+        scratch.next_ids.clear();
+        for ( auto const& b : scratch.blocks ) {
+          size_type* ids = scratch.ids.data() + b.begin;
+          size_type first = npos;
+          size_type last = 0;
+          size_type active = 0;
+          for ( size_type j = 0; j < b.len; ++j ) {
+            if ( ids[ j ] == npos ) continue;
+            size_type row = b.lb + j;
+            if ( fm.sa_sample.is_sampled( row ) ) {
+              out[ ids[ j ] ] = wrap( fm.sa_sample[ row ] + off );
+              ids[ j ] = npos;
+              continue;
+            }
+            if ( first == npos ) first = j;
+            last = j;
+            ++active;
+          }
+          if ( active == 0 ) continue;
+          if ( active < MIN_BLOCK_ROWS || active * 2 < last + 1 - first ) {
+            for ( size_type j = first; j <= last; ++j ) {
+              if ( ids[ j ] != npos ) out[ ids[ j ] ] = wrap( fm[ b.lb + j ] + off );
+            }
+            continue;
+          }
+          sdsl::range_type r = {{ b.lb + first, b.lb + last }};
+          _lf_block( fm, fm.wavelet_tree.root(), r, ids + first, scratch );
+        }
+        std::swap( scratch.blocks, scratch.next_blocks );
+        std::swap( scratch.ids, scratch.next_ids );
+      }
+    }
+
+  /**
+   *  @brief  Locate the SA values of a range of rows.
+   *
+   *  @param  fm The FM index.
+   *  @param  lb The first row.
+   *  @param  rb The last row (inclusive).
+   *  @param  out The output buffer with room for `rb - lb + 1` values; the value of
+   *              row `lb + i` is written to `out[i]`.
+   *  @param  scratch The scratch memory.
+   *
+   *  It is equivalent to `out[i] = fm[lb + i]`, but the LF walks of the rows in the
+   *  range share the wavelet tree traversals when the CSA allows it.
+   */
+  template< typename TCSA >
+      inline void
+    locate( TCSA const& fm, uint64_t lb, uint64_t rb, uint64_t* out, LocateScratch& scratch )
+    {
+      if ( lb > rb ) return;
+      _locate( fm, lb, rb, out, scratch, has_wt_nodes< TCSA >() );
+    }
+
+  /**
+   *  @brief  Construct a CSA of a byte text using multiple threads.
+   *
+   *  @param  csa The CSA to be constructed.
+   *  @param  text The text; it is terminated by a zero symbol in place and released.
+   *  @param  config The sdsl cache configuration.
+   *  @param  nof_threads The number of threads.
+   *
+   *  The text, its suffix array and its BWT are stored in the sdsl cache before
+   *  the CSA is constructed from the cache; i.e. the same steps as `sdsl::construct`.
+   *  The suffix array is computed by libsais using all threads if it is available
+   *  (`PSI_USE_LIBSAIS`); otherwise, by sdsl. The BWT is then computed from the
+   *  suffix array in parallel chunks.
+   */
+  template< typename TCSA >
+      inline void
+    construct_csa( TCSA& csa, sdsl::int_vector< 8 >& text, sdsl::cache_config& config,
+                   unsigned int nof_threads )
+    {
+      static_assert( TCSA::alphabet_category::WIDTH == 8, "only byte alphabets are supported" );
+
+      if ( nof_threads == 0 ) nof_threads = 1;
+      if ( std::memchr( text.data(), 0, text.size() ) != nullptr ) {
+        throw std::runtime_error( "the text of the FM index should not contain zero symbols" );
+      }
+      sdsl::append_zero_symbol( text );
+      sdsl::store_to_cache( text, sdsl::conf::KEY_TEXT, config );
+      std::size_t n = text.size();
+
+      sdsl::int_vector<> sa;
+#ifdef PSI_USE_LIBSAIS
+      sa = sdsl::int_vector<>( n, 0, 64 );
+      if ( libsais64_omp( reinterpret_cast< uint8_t const* >( text.data() ),
+                          reinterpret_cast< int64_t* >( sa.data() ), n, 0, nullptr,
+                          nof_threads ) != 0 ) {
+        throw std::runtime_error( "failed to construct the suffix array" );
+      }
+      sdsl::store_to_cache( sa, sdsl::conf::KEY_SA, config );
+#else
+      sdsl::construct_sa< 8 >( config );
+      sdsl::load_from_cache( sa, sdsl::conf::KEY_SA, config );
+#endif  /* ----- #ifdef PSI_USE_LIBSAIS  ----- */
+
+      {
+        sdsl::int_vector< 8 > bwt( n );
+        std::size_t chunk = ( n + nof_threads - 1 ) / nof_threads;
+        auto worker = [&]( std::size_t first ) {
+          std::size_t last = std::min( first + chunk, n );
+          for ( std::size_t i = first; i < last; ++i ) {
+            uint64_t pos = sa[ i ];
+            bwt[ i ] = text[ pos != 0 ? pos - 1 : n - 1 ];
+          }
+        };
+        std::vector< std::thread > workers;
+        for ( std::size_t first = chunk; first < n; first += chunk ) {
+          workers.emplace_back( worker, first );
+        }
+        worker( 0 );
+        for ( auto& w : workers ) w.join();
+        sdsl::store_to_cache( bwt, sdsl::conf::KEY_BWT, config );
+      }
+      sdsl::util::clear( sa );
+      sdsl::util::clear( text );
+
+      {
+        TCSA tmp( config );
+        csa.swap( tmp );
+      }
+      if ( config.delete_files ) sdsl::util::delete_all_files( config.file_map );
+    }
 }  /* --- end of namespace psi --- */
 
 namespace seqan2 {
@@ -47,25 +557,25 @@ namespace seqan2 {
       void
     indexRequire(
         Index< psi::YaString< psi::DiskBased >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF );
+        FibreSALF, unsigned int nof_threads=1 );
 
   template< class TWT, uint32_t TDens, uint32_t TInvDens >
       void
     indexRequire(
         Index< psi::YaString< psi::InMemory >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF );
+        FibreSALF, unsigned int nof_threads=1 );
 
   template< class TWT, uint32_t TDens, uint32_t TInvDens >
       void
     indexRequire(
         Index< StringSet< psi::YaString< psi::DiskBased > >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF );
+        FibreSALF, unsigned int nof_threads=1 );
 
   template< class TWT, uint32_t TDens, uint32_t TInvDens >
       void
     indexRequire(
         Index< StringSet< psi::YaString< psi::InMemory > >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF );
+        FibreSALF, unsigned int nof_threads=1 );
 
   template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens >
       typename Index< TText, psi::FMIndex< TWT, TDens, TInvDens > >::text_type&
@@ -89,6 +599,10 @@ namespace seqan2 {
         typedef char char_type;
         typedef typename value_type::comp_char_type comp_char_type;
         typedef typename std::pair< savalue_type, savalue_type > range_type;
+        typedef psi::QGramTable qgram_table_type;
+        /* ====================  CONSTANTS     ======================================= */
+        constexpr static const uint32_t SA_SAMPLE_DENS = TDens;
+        constexpr static const uint32_t ISA_SAMPLE_DENS = TInvDens;
         /* ====================  LIFECYCLE     ======================================= */
         Index ( )
           : text_p( nullptr ), owner( true ) { }
@@ -111,6 +625,12 @@ namespace seqan2 {
         {
           return this->owner;
         }
+
+          inline qgram_table_type const&
+        get_qgram_table( ) const
+        {
+          return this->qgram;
+        }
         /* ====================  METHODS       ======================================= */
           inline savalue_type
         size( ) const
@@ -124,10 +644,30 @@ namespace seqan2 {
           return this->size() == 0;
         }
 
+        /**
+         *  @brief  Get the size of the FM index in bytes (excluding the text).
+         */
+          inline uint64_t
+        size_in_bytes( ) const
+        {
+          return sdsl::size_in_bytes( this->fm ) + sdsl::size_in_bytes( this->qgram.get_bounds() );
+        }
+
+        /**
+         *  @brief  Get the size of the SA and ISA samples of the FM index in bytes.
+         */
+          inline uint64_t
+        samples_size_in_bytes( ) const
+        {
+          return sdsl::size_in_bytes( this->fm.sa_sample ) +
+              sdsl::size_in_bytes( this->fm.isa_sample );
+        }
+
           inline void
         clear_fibres( )
         {
           sdsl::util::clear( this->fm );
+          this->qgram.clear();
         }
 
           inline void
@@ -146,13 +686,39 @@ namespace seqan2 {
           return ( this->fm.size() == 0 ) && ( this->text_p != nullptr );
         }
 
+        /**
+         *  @brief  Build the q-gram lookup table fibre (see `QGramTable`).
+         *
+         *  @param  q The length of the q-grams; zero removes the table.
+         *  @param  nof_threads The number of threads.
+         *
+         *  NOTE: The FM index should be constructed beforehand.
+         */
+          inline void
+        create_qgram_table( unsigned int q, unsigned int nof_threads=1 )
+        {
+          this->qgram.build( this->fm, q, nof_threads );
+        }
+
           inline void
         serialize( std::ostream& out )
         {
           this->fm.serialize( out );
           this->text_p->serialize( out );
-        }
-
+          psi::serialize( out, Index::TRAILER_TAG );
+          psi::serialize( out, static_cast< uint64_t >( TDens ) );
+          psi::serialize( out, static_cast< uint64_t >( TInvDens ) );
+          this->qgram.serialize( out );
+        }
+
+        /**
+         *  @brief  Load the index from the input stream.
+         *
+         *  The sampling densities recorded in the stream should match the ones of this
+         *  index type; otherwise a `std::runtime_error` is thrown. The streams written
+         *  before recording the densities have no trailer and are assumed to have the
+         *  default sampling densities.
+         */
           inline void
         load( std::istream& in )
         {
@@ -162,6 +728,32 @@ namespace seqan2 {
           this->text_p = new text_type();
           this->text_p->load( in );
           this->owner = true;
+
+          auto pos = in.tellg();
+          uint64_t tag = 0;
+          in.read( reinterpret_cast< char* >( &tag ), sizeof( tag ) );
+          if ( in.gcount() == static_cast< std::streamsize >( sizeof( tag ) ) &&
+               tag == Index::TRAILER_TAG ) {
+            uint64_t sa_dens;
+            uint64_t isa_dens;
+            psi::deserialize( in, sa_dens );
+            psi::deserialize( in, isa_dens );
+            if ( sa_dens != TDens || isa_dens != TInvDens ) {
+              throw std::runtime_error( "mismatched FM index sampling profile (SA/ISA: " +
+                                        std::to_string( sa_dens ) + "/" +
+                                        std::to_string( isa_dens ) + ", expected: " +
+                                        std::to_string( TDens ) + "/" +
+                                        std::to_string( TInvDens ) + ")" );
+            }
+            this->qgram.load( in );
+          }
+          else {
+            if ( !std::is_same< spec_type, psi::FMIndex< TWT > >::value ) {
+              throw std::runtime_error( "no FM index sampling profile recorded" );
+            }
+            in.clear();
+            in.seekg( pos );
+          }
         }
 
         // :TODO:Wed Apr 04 13:17:\@cartoonist: FIXME: a Holder class should be
@@ -192,13 +784,17 @@ namespace seqan2 {
           this->owner = false;
         }
       private:
+        /* ====================  CONSTANTS     ======================================= */
+        /** @brief Marks the trailer recording sampling densities and q-gram table. */
+        constexpr static const uint64_t TRAILER_TAG = 0x4c4941525450534dULL;
         /* ====================  DATA MEMBERS  ======================================= */
         value_type fm;
+        qgram_table_type qgram;
         text_type* text_p;
         bool owner;
         /* ====================  INTERFACE FUNCTIONS  ================================ */
           friend void
-        indexRequire< TWT, TDens, TInvDens >( Index& index, FibreSALF );
+        indexRequire< TWT, TDens, TInvDens >( Index& index, FibreSALF, unsigned int );
           friend text_type&
         getFibre< TText, TWT, TDens, TInvDens >( Index&, FibreText );
           friend text_type const&
@@ -215,7 +811,7 @@ namespace seqan2 {
       inline void
     indexRequire(
         Index< psi::YaString< psi::DiskBased >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF )
+        FibreSALF, unsigned int nof_threads )
     {
       if ( index.constructible() ) {
         std::string tmpdir = psi::get_tmpdir_env();
@@ -223,7 +819,13 @@ namespace seqan2 {
         if ( tmpdir.size() != 0 ) {
           config.dir = std::move( tmpdir );
         }
-        construct( index.fm, index.text_p->get_file_path(), config, 1 );
+        if ( nof_threads > 1 ) {
+          sdsl::int_vector< 8 > text;
+          sdsl::load_vector_from_file( text, index.text_p->get_file_path(), 1 );
+          psi::construct_csa( index.fm, text, config, nof_threads );
+        }
+        // NOTE: The last argument is the width of the input symbols in bytes.
+        else construct( index.fm, index.text_p->get_file_path(), config, 1 );
       }
     }
 
@@ -231,9 +833,18 @@ namespace seqan2 {
       inline void
     indexRequire(
         Index< psi::YaString< psi::InMemory >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF )
+        FibreSALF, unsigned int nof_threads )
     {
-      if ( index.constructible() ) construct_im( index.fm, index.text_p->c_str(), 1 );
+      if ( !index.constructible() ) return;
+      if ( nof_threads > 1 ) {
+        sdsl::int_vector< 8 > text( index.text_p->raw_length() );
+        std::memcpy( text.data(), index.text_p->c_str(), text.size() );
+        /* Cache files in RAM as `construct_im` does. */
+        sdsl::cache_config config( true, "@" );
+        psi::construct_csa( index.fm, text, config, nof_threads );
+      }
+      // NOTE: The last argument is the width of the input symbols in bytes.
+      else construct_im( index.fm, index.text_p->c_str(), 1 );
     }
 
   template< class TWT, uint32_t TDens, uint32_t TInvDens >
@@ -258,7 +869,7 @@ namespace seqan2 {
       inline void
     indexRequire(
         Index< StringSet< psi::YaString< psi::DiskBased > >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF )
+        FibreSALF, unsigned int nof_threads )
     {
       if ( index.constructible() ) {
         std::string tmpdir = psi::get_tmpdir_env();
@@ -266,7 +877,13 @@ namespace seqan2 {
         if ( tmpdir.size() != 0 ) {
           config.dir = std::move( tmpdir );
         }
-        construct( index.fm, index.text_p->get_file_path(), config, 1 );
+        if ( nof_threads > 1 ) {
+          sdsl::int_vector< 8 > text;
+          sdsl::load_vector_from_file( text, index.text_p->get_file_path(), 1 );
+          psi::construct_csa( index.fm, text, config, nof_threads );
+        }
+        // NOTE: The last argument is the width of the input symbols in bytes.
+        else construct( index.fm, index.text_p->get_file_path(), config, 1 );
       }
     }
 
@@ -274,9 +891,18 @@ namespace seqan2 {
       inline void
     indexRequire(
         Index< StringSet< psi::YaString< psi::InMemory > >, psi::FMIndex< TWT, TDens, TInvDens > >& index,
-        FibreSALF )
+        FibreSALF, unsigned int nof_threads )
     {
-      if ( index.constructible() ) construct_im( index.fm, index.text_p->c_str(), 1 );
+      if ( !index.constructible() ) return;
+      if ( nof_threads > 1 ) {
+        sdsl::int_vector< 8 > text( index.text_p->raw_length() );
+        std::memcpy( text.data(), index.text_p->c_str(), text.size() );
+        /* Cache files in RAM as `construct_im` does. */
+        sdsl::cache_config config( true, "@" );
+        psi::construct_csa( index.fm, text, config, nof_threads );
+      }
+      // NOTE: The last argument is the width of the input symbols in bytes.
+      else construct_im( index.fm, index.text_p->c_str(), 1 );
     }
 
   template< class TWT, uint32_t TDens, uint32_t TInvDens >
@@ -325,14 +951,29 @@ namespace seqan2 {
       return index.size();
     }
 
+  /**
+   *  @brief  Open an FM index from file.
+   *
+   *  @return `false` if the file cannot be opened.
+   *
+   *  It throws a `std::runtime_error` if the index in the file is of another sampling
+   *  profile (see `Index::load`); so that a valid index is not taken as missing and
+   *  overwritten by the caller. The index is left empty in this case.
+   */
   template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens >
       inline bool
     open( Index< TText, psi::FMIndex< TWT, TDens, TInvDens > >& index,
         const std::string& file_name )
     {
-      std::ifstream ifs( file_name, std::ifstream::in | std::ifstream::binary );
+      MappedIStream ifs( file_name );
       if( !ifs ) return false;
-      open( index, ifs );
+      try {
+        open( index, ifs );
+      }
+      catch ( ... ) {
+        index.clear();
+        throw;
+      }
       return true;
     }
 
@@ -543,6 +1184,9 @@ namespace seqan2 {
   template< typename TIndex, typename TSpec >
     class IterHistory;
 
+  /**
+   *  @brief  History of a top-down iterator with parent links: the ranges of all ancestors.
+   */
   template< typename TIndex >
     class IterHistory< TIndex, TopDown< ParentLinks<> > > {
       public:
@@ -609,6 +1253,12 @@ namespace seqan2 {
         container_type stack;
     };
 
+  /**
+   *  @brief  History of a plain top-down iterator: only the range of the parent.
+   *
+   *  It is enough for going right and is stored inline; so copying the iterator, e.g.
+   *  in traversal states, never allocates.
+   */
   template< typename TIndex >
     class IterHistory< TIndex, TopDown<> > {
       public:
@@ -762,20 +1412,73 @@ namespace seqan2 {
           return _this->get_position( i );
         }
 
-          inline occs_type
-        get_occurrences( ) const
+        /**
+         *  @brief  Locate the raw positions of all occurrences in the SA order.
+         *
+         *  @param[out]  out The output buffer; it is resized to the number of
+         *                   occurrences, so its capacity is reused across calls.
+         *  @param  scratch The scratch memory [default: the one of the calling thread].
+         *
+         *  The LF walks of the occurrences are shared (see `psi::locate`). There is
+         *  no occurrence at the root.
+         */
+          inline void
+        get_raw_positions( std::vector< savalue_type >& out,
+            psi::LocateScratch& scratch=psi::LocateScratch::get() ) const
         {
-          savalue_type occs_no;
-          if ( this->is_root() ) occs_no = 0;
-          else occs_no = this->count();
-          occs_type occs( occs_no );
+          if ( this->is_root() ) {
+            out.clear();
+            return;
+          }
+          out.resize( this->count() );
+          psi::locate( this->index_p->fm, this->occ_cur, this->occ_end, out.data(), scratch );
+        }
 
-          for ( savalue_type i = 0; i < occs_no; ++i ) {
-            occs[i] = this->get_position( i );
+        /**
+         *  @brief  Locate all occurrences into a caller-supplied buffer.
+         *
+         *  @param[out]  occs The output buffer; it is resized to the number of
+         *                    occurrences, so its capacity is reused across calls.
+         *  @param  scratch The scratch memory [default: the one of the calling thread].
+         */
+          inline void
+        get_occurrences( occs_type& occs,
+            psi::LocateScratch& scratch=psi::LocateScratch::get() ) const
+        {
+          this->get_raw_positions( scratch.positions, scratch );
+          occs.resize( scratch.positions.size() );
+          for ( std::size_t i = 0; i < occs.size(); ++i ) {
+            occs[ i ] = this->index_p->text_p->get_position( scratch.positions[ i ] );
           }
+        }
+
+          inline occs_type
+        get_occurrences( ) const
+        {
+          occs_type occs;
+          this->get_occurrences( occs );
           return occs;
         }
 
+        /**
+         *  @brief  Call `callback` for each occurrence in the SA order without allocation.
+         *
+         *  @param  callback The callback taking the position of an occurrence.
+         *  @param  scratch The scratch memory [default: the one of the calling thread].
+         *
+         *  NOTE: The callback should not locate occurrences using the same scratch.
+         */
+        template< typename TCallback >
+            inline void
+          for_each_occurrence( TCallback callback,
+              psi::LocateScratch& scratch=psi::LocateScratch::get() ) const
+          {
+            this->get_raw_positions( scratch.positions, scratch );
+            for ( auto raw : scratch.positions ) {
+              callback( this->index_p->text_p->get_position( raw ) );
+            }
+          }
+
           inline void
         reserve_history( savalue_type size )
         {
@@ -868,6 +1571,61 @@ namespace seqan2 {
           return no;
         }
 
+          inline unsigned int
+        qgram_length( ) const
+        {
+          return this->index_p->qgram.get_q();
+        }
+
+        /**
+         *  @brief  Jump from the root to the node of the given q-gram.
+         *
+         *  @param  code The packed q-gram (see `QGramTable`).
+         *  @return The number of occurrences of the q-gram.
+         *
+         *  It is equivalent to going down along the `q` characters of the q-gram in
+         *  one step using the q-gram table of the index. The iterator is not changed if
+         *  the q-gram does not occur. Since the intermediate nodes are skipped, the
+         *  iterator cannot go up above the q-gram node afterwards; i.e. it behaves as
+         *  the root of a sub-tree.
+         *
+         *  NOTE: The index should have a q-gram table and the iterator should be at
+         *  the root.
+         */
+          inline savalue_type
+        go_down_qgram( typename psi::QGramTable::code_type code )
+        {
+          if ( !this->is_initialized() ) this->go_root();
+          assert( this->depth == 0 && !this->index_p->qgram.empty() );
+          auto r = this->index_p->qgram.range( code );
+          if ( r.first > r.second ) return 0;
+          this->occ_cur = r.first;
+          this->occ_end = r.second;
+          this->depth = this->qgram_length();
+          this->history.clear();
+          return this->count();
+        }
+
+        /**
+         *  @brief  Prefetch the memory blocks touched by the next `go_down` call.
+         *
+         *  Each backward search step is two dependent rank queries starting at the
+         *  root level of the wavelet tree at positions `occ_cur` and `occ_end + 1`,
+         *  regardless of the character. Prefetching them for a group of independent
+         *  iterators before going down overlaps their cache misses.
+         */
+          inline void
+        prefetch( ) const
+        {
+          typedef typename index_type::value_type csa_type;
+          if constexpr ( psi::has_wt_bits< csa_type >::value ) {
+            if ( !this->is_initialized() || this->at_end() ) return;
+            auto data = this->index_p->fm.wavelet_tree.bv.data();
+            __builtin_prefetch( data + ( this->occ_cur >> 6 ) );
+            __builtin_prefetch( data + ( ( this->occ_end + 1 ) >> 6 ) );
+          }
+        }
+
           inline savalue_type
         go_down_gt( char_type c )  /**< @brief go down with any character larger than c */
         {
@@ -967,6 +1725,13 @@ namespace seqan2 {
       return iter.go_down( c ) != 0;
     }
 
+  template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens, typename TSpec >
+      inline void
+    prefetch( Iter< Index< TText, psi::FMIndex< TWT, TDens, TInvDens > >, TopDown< TSpec > > const& iter )
+    {
+      iter.prefetch();
+    }
+
   template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens, typename TSpec >
       inline bool
     goUp( Iter< Index< TText, psi::FMIndex< TWT, TDens, TInvDens > >, TopDown< TSpec > >& iter )
@@ -77,6 +77,13 @@ namespace psi {
       TOffset m_offset;
   };
 
+  /**
+   *  @brief  Positions are serialised bitwise; e.g. the starting loci.
+   */
+  template< typename TId, typename TOffset >
+    class is_bitwise_serializable< PositionBase< TId, TOffset > > : public std::true_type {
+    };
+
   template< typename TId = typename gum::GraphBaseTrait< gum::Dynamic >::id_type,
             typename TOffset = typename gum::GraphBaseTrait< gum::Dynamic >::offset_type >
   using Position = psi::PositionBase< TId, TOffset >;
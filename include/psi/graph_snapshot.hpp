@@ -0,0 +1,417 @@
+/**
+ *    @file  graph_snapshot.hpp
+ *   @brief  Read-only snapshot of a sequence graph optimised for traversal.
+ *
+ *  This header file contains a read-only snapshot of a sequence graph whose node
+ *  sequences and out-edges are laid out contiguously in rank order; so that the
+ *  traversals step through the graph with fewer cache misses.
+ *
+ *  @author  Ali Ghaffaari (\@cartoonist), <ali.ghaffaari@mpi-inf.mpg.de>
+ *
+ *  @internal
+ *       Created:  Fri Oct 16, 2026  16:40
+ *  Organization:  Max-Planck-Institut fuer Informatik
+ *     Copyright:  Copyright (c) 2026, Ali Ghaffaari
+ *
+ *  This source code is released under the terms of the MIT License.
+ *  See LICENSE file for more information.
+ */
+
+#ifndef  PSI_GRAPH_SNAPSHOT_HPP__
+#define  PSI_GRAPH_SNAPSHOT_HPP__
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+#include <sdsl/bit_vectors.hpp>
+
+
+namespace psi {
+  /* Forwards */
+  template< class TGraph >
+    class GraphSnapshot;
+
+  /**
+   *  @brief  View of a graph snapshot whose nodes are identified by their ranks.
+   *
+   *  @tparam  TGraph The graph type.
+   *
+   *  It has the same traversal interface as the snapshot, but the nodes are passed to
+   *  and from its methods by their ranks; so that stepping through the snapshot does
+   *  not map node IDs to ranks by the graph. The traversals convert the node ID of
+   *  a starting locus to its node handle once by `node_handle` (see below).
+   */
+  template< class TGraph >
+    class SnapshotRankView {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef GraphSnapshot< TGraph > snapshot_type;
+        typedef typename snapshot_type::id_type id_type;
+        typedef typename snapshot_type::offset_type offset_type;
+        typedef typename snapshot_type::rank_type rank_type;
+        typedef typename snapshot_type::linktype_type linktype_type;
+        typedef typename snapshot_type::size_type size_type;
+        typedef typename snapshot_type::sequence_type sequence_type;
+        /* ====================  LIFECYCLE     ======================================= */
+        SnapshotRankView( snapshot_type const& s ) : snapshot_ptr( &s ) { }
+        /* ====================  METHODS       ======================================= */
+          inline rank_type
+        node_handle( id_type id ) const
+        {
+          return this->snapshot_ptr->id_to_rank( id );
+        }
+
+          inline offset_type
+        node_length( rank_type rank ) const
+        {
+          return this->snapshot_ptr->node_length_by_rank( rank );
+        }
+
+          inline sequence_type
+        node_sequence( rank_type rank ) const
+        {
+          return this->snapshot_ptr->node_sequence_by_rank( rank );
+        }
+
+          inline size_type
+        outdegree( rank_type rank ) const
+        {
+          return this->snapshot_ptr->outdegree_by_rank( rank );
+        }
+
+          inline bool
+        has_edges_out( rank_type rank ) const
+        {
+          return this->outdegree( rank ) != 0;
+        }
+
+        /**
+         *  @brief  Call `callback( to_rank, type )` for each out-edge of a node.
+         */
+        template< typename TCallback >
+          inline bool
+        for_each_edges_out( rank_type rank, TCallback callback ) const
+        {
+          return this->snapshot_ptr->for_each_edges_out_by_rank( rank, callback );
+        }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        snapshot_type const* snapshot_ptr;
+    };  /* --- end of template class SnapshotRankView --- */
+
+  /**
+   *  @brief  Read-only traversal-optimised snapshot of a sequence graph.
+   *
+   *  @tparam  TGraph The graph type.
+   *
+   *  The node sequences are concatenated in rank order and 2-bit packed; the non-ACGT
+   *  characters are marked in a separate bit vector and read as 'N' (lowercase
+   *  nucleotides are read as uppercase). The out-edges are stored in a flat array in
+   *  compressed sparse row (CSR) format by the rank of their source nodes.
+   *
+   *  It provides the subset of the graph interface used by traversals (i.e.
+   *  `node_sequence`, `node_length`, `has_edges_out`, `outdegree`, and
+   *  `for_each_edges_out`) so that they can run on either of them. Node sequences are
+   *  returned as lightweight views into the packed sequence instead of decoded
+   *  strings. The same methods are available by node rank (`*_by_rank` and
+   *  `rank_view`) which do not touch the graph at all.
+   *
+   *  The node IDs are still mapped to ranks by the graph; so the graph should outlive
+   *  the snapshot. The snapshot is not updated if the graph is modified afterwards.
+   */
+  template< class TGraph >
+    class GraphSnapshot {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef TGraph graph_type;
+        typedef typename graph_type::id_type id_type;
+        typedef typename graph_type::offset_type offset_type;
+        typedef typename graph_type::rank_type rank_type;
+        typedef typename graph_type::linktype_type linktype_type;
+        typedef std::pair< rank_type, linktype_type > edge_type;
+        typedef std::size_t size_type;
+        typedef SnapshotRankView< graph_type > rank_view_type;
+
+        /**
+         *  @brief  View of a node sequence in the packed concatenated sequence.
+         */
+        class NodeSequence {
+          public:
+            /* ====================  LIFECYCLE     =================================== */
+            NodeSequence( GraphSnapshot const* ptr, size_type pos, offset_type length )
+              : snapshot_ptr( ptr ), begin_pos( pos ), len( length )
+            { }
+            /* ====================  OPERATORS     =================================== */
+              inline char
+            operator[]( offset_type i ) const
+            {
+              return this->snapshot_ptr->char_at( this->begin_pos + i );
+            }
+            /* ====================  METHODS       =================================== */
+              inline offset_type
+            size( ) const
+            {
+              return this->len;
+            }
+          private:
+            /* ====================  DATA MEMBERS  =================================== */
+            GraphSnapshot const* snapshot_ptr;
+            size_type begin_pos;
+            offset_type len;
+        };  /* --- end of class NodeSequence --- */
+
+        typedef NodeSequence sequence_type;
+
+        /* ====================  LIFECYCLE     ======================================= */
+        GraphSnapshot( ) : graph_ptr( nullptr ) { }
+
+        GraphSnapshot( graph_type const& graph )
+          : GraphSnapshot( )
+        {
+          this->build( graph );
+        }
+
+        GraphSnapshot( GraphSnapshot const& ) = default;
+        GraphSnapshot( GraphSnapshot&& ) = default;
+        GraphSnapshot& operator=( GraphSnapshot const& ) = default;
+        GraphSnapshot& operator=( GraphSnapshot&& ) = default;
+        ~GraphSnapshot( ) = default;
+
+        /* ====================  ACCESSORS     ======================================= */
+          inline graph_type const*
+        get_graph_ptr( ) const
+        {
+          return this->graph_ptr;
+        }
+
+          inline rank_view_type
+        rank_view( ) const
+        {
+          return rank_view_type( *this );
+        }
+
+        /* ====================  METHODS       ======================================= */
+        /**
+         *  @brief  Take a snapshot of the graph.
+         *
+         *  The nodes are visited twice: first to size the arrays and then to fill them.
+         */
+          inline void
+        build( graph_type const& graph )
+        {
+          this->clear();
+          this->graph_ptr = &graph;
+
+          size_type nof_nodes = graph.get_node_count();
+          size_type seqlen = 0;
+          size_type nof_edges = 0;
+          graph.for_each_node(
+              [&]( rank_type, id_type id ) {
+                seqlen += graph.node_length( id );
+                nof_edges += graph.outdegree( id );
+                return true;
+              } );
+
+          this->node_ids.reserve( nof_nodes );
+          this->seq_begins.reserve( nof_nodes + 1 );
+          this->edge_begins.reserve( nof_nodes + 1 );
+          this->edges.reserve( nof_edges );
+          sdsl::int_vector< 2 > bases( seqlen, 0 );
+          sdsl::bit_vector nmask( seqlen, 0 );
+
+          size_type pos = 0;
+          graph.for_each_node(
+              [&]( rank_type, id_type id ) {
+                this->node_ids.push_back( id );
+                this->seq_begins.push_back( pos );
+                for ( char c : graph.node_sequence( id ) ) {
+                  switch ( c ) {
+                    case 'A': case 'a': bases[ pos ] = 0; break;
+                    case 'C': case 'c': bases[ pos ] = 1; break;
+                    case 'G': case 'g': bases[ pos ] = 2; break;
+                    case 'T': case 't': bases[ pos ] = 3; break;
+                    default: nmask[ pos ] = 1;
+                  }
+                  ++pos;
+                }
+                this->edge_begins.push_back( this->edges.size() );
+                graph.for_each_edges_out(
+                    id,
+                    [this, &graph]( id_type to, linktype_type type ) {
+                      this->edges.emplace_back( graph.id_to_rank( to ), type );
+                      return true;
+                    } );
+                return true;
+              } );
+          this->seq_begins.push_back( pos );
+          this->edge_begins.push_back( this->edges.size() );
+          this->bases.swap( bases );
+          this->nmask.swap( nmask );
+        }
+
+          inline void
+        clear( )
+        {
+          this->graph_ptr = nullptr;
+          this->node_ids.clear();
+          this->seq_begins.clear();
+          this->edge_begins.clear();
+          this->edges.clear();
+          sdsl::util::clear( this->bases );
+          sdsl::util::clear( this->nmask );
+        }
+
+          inline bool
+        empty( ) const
+        {
+          return this->graph_ptr == nullptr;
+        }
+
+          inline size_type
+        get_node_count( ) const
+        {
+          return this->node_ids.size();
+        }
+
+          inline size_type
+        get_edge_count( ) const
+        {
+          return this->edges.size();
+        }
+
+          inline size_type
+        get_sequence_len( ) const
+        {
+          return this->bases.size();
+        }
+
+          inline rank_type
+        id_to_rank( id_type id ) const
+        {
+          return this->graph_ptr->id_to_rank( id );
+        }
+
+          inline id_type
+        rank_to_id( rank_type rank ) const
+        {
+          return this->node_ids[ rank - 1 ];
+        }
+
+        /**
+         *  @brief  Get the character at a position of the concatenated sequence.
+         */
+          inline char
+        char_at( size_type pos ) const
+        {
+          constexpr static const char DNA[] = { 'A', 'C', 'G', 'T' };
+          if ( this->nmask[ pos ] ) return 'N';
+          return DNA[ this->bases[ pos ] ];
+        }
+
+          inline offset_type
+        node_length_by_rank( rank_type rank ) const
+        {
+          return this->seq_begins[ rank ] - this->seq_begins[ rank - 1 ];
+        }
+
+          inline offset_type
+        node_length( id_type id ) const
+        {
+          return this->node_length_by_rank( this->id_to_rank( id ) );
+        }
+
+          inline sequence_type
+        node_sequence_by_rank( rank_type rank ) const
+        {
+          return sequence_type( this, this->seq_begins[ rank - 1 ],
+                                this->node_length_by_rank( rank ) );
+        }
+
+          inline sequence_type
+        node_sequence( id_type id ) const
+        {
+          return this->node_sequence_by_rank( this->id_to_rank( id ) );
+        }
+
+          inline size_type
+        outdegree_by_rank( rank_type rank ) const
+        {
+          return this->edge_begins[ rank ] - this->edge_begins[ rank - 1 ];
+        }
+
+          inline size_type
+        outdegree( id_type id ) const
+        {
+          return this->outdegree_by_rank( this->id_to_rank( id ) );
+        }
+
+          inline bool
+        has_edges_out( id_type id ) const
+        {
+          return this->outdegree( id ) != 0;
+        }
+
+        /**
+         *  @brief  Call `callback( to_rank, type )` for each out-edge of a node.
+         *
+         *  The iteration stops if the callback returns `false` (similar to the graph).
+         */
+        template< typename TCallback >
+          inline bool
+        for_each_edges_out_by_rank( rank_type rank, TCallback callback ) const
+        {
+          auto end = this->edge_begins[ rank ];
+          for ( auto i = this->edge_begins[ rank - 1 ]; i < end; ++i ) {
+            auto const& edge = this->edges[ i ];
+            if ( !callback( edge.first, edge.second ) ) return false;
+          }
+          return true;
+        }
+
+        /**
+         *  @brief  Call `callback( to, type )` for each out-edge of a node.
+         */
+        template< typename TCallback >
+          inline bool
+        for_each_edges_out( id_type id, TCallback callback ) const
+        {
+          return this->for_each_edges_out_by_rank(
+              this->id_to_rank( id ),
+              [this, &callback]( rank_type to, linktype_type type ) {
+                return callback( this->rank_to_id( to ), type );
+              } );
+        }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        graph_type const* graph_ptr;
+        sdsl::int_vector< 2 > bases;           /**< @brief 2-bit packed sequence. */
+        sdsl::bit_vector nmask;                /**< @brief Non-ACGT characters. */
+        std::vector< id_type > node_ids;       /**< @brief Node IDs by rank. */
+        std::vector< size_type > seq_begins;   /**< @brief Sequence offsets by rank. */
+        std::vector< size_type > edge_begins;  /**< @brief Edge offsets by rank (CSR). */
+        std::vector< edge_type > edges;        /**< @brief Out-edges by target rank. */
+    };  /* --- end of template class GraphSnapshot --- */
+
+  /**
+   *  @brief  Get the handle of a node by which a traversal steps through a graph.
+   *
+   *  The nodes of a graph are identified by their IDs, and the ones of a snapshot
+   *  rank view by their ranks.
+   */
+  template< class TGraph >
+      inline typename TGraph::id_type
+    node_handle( TGraph const&, typename TGraph::id_type id )
+    {
+      return id;
+    }
+
+  template< class TGraph >
+      inline typename TGraph::rank_type
+    node_handle( SnapshotRankView< TGraph > const& view, typename TGraph::id_type id )
+    {
+      return view.node_handle( id );
+    }
+}  /* --- end of namespace psi --- */
+
+#endif  /* --- #ifndef PSI_GRAPH_SNAPSHOT_HPP__ --- */
@@ -24,6 +24,7 @@
 
 #include "sequence.hpp"
 #include "fmindex.hpp"
+#include "kmerindex.hpp"
 
 
 namespace psi {
@@ -50,6 +51,24 @@ namespace psi {
       indexRequire( index, seqan2::FibreChildtab() );
     }
 
+  /**
+   *  @brief  Fully construct a lazy suffix tree index.
+   *
+   *  The nodes of a WOTD index are evaluated on demand during top-down traversal
+   *  which modifies the index. Evaluating all nodes beforehand makes the index safe to
+   *  be traversed by multiple threads concurrently.
+   */
+  template< typename TText, typename TSpec >
+      inline void
+    create_index( seqan2::Index< TText, seqan2::IndexWotd< TSpec > >& index )
+    {
+      typedef seqan2::Index< TText, seqan2::IndexWotd< TSpec > > TIndex;
+      typedef seqan2::TopDown< seqan2::ParentLinks< seqan2::Preorder > > TIterSpec;
+
+      typename seqan2::Iterator< TIndex, TIterSpec >::Type itr( index );
+      while ( !atEnd( itr ) ) goNext( itr );
+    }
+
   template< typename TIndex >
       inline void
     _create_fm_index( TIndex& index )
@@ -71,11 +90,79 @@ namespace psi {
       _create_fm_index( index );
     }
 
+  /**
+   *  @brief  Construct an FM index using multiple threads (see `construct_csa`).
+   */
   template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens >
       inline void
-    create_index( seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >& index )
+    create_index( seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >& index,
+        unsigned int nof_threads=1 )
     {
-      _create_fm_index( index );
+      indexRequire( index, seqan2::FibreSALF(), nof_threads );
+    }
+
+  /**
+   *  @brief  The k-mer index is built on construction.
+   */
+  template< typename TText, typename TSpec >
+      inline void
+    create_index( seqan2::Index< TText, KmerIndex< TSpec > >& )
+    { /* NOOP */ }
+
+  /**
+   *  @brief  Create an index whose construction is not multi-threaded.
+   */
+  template< typename TText, typename TIndexSpec >
+      inline void
+    create_index( seqan2::Index< TText, TIndexSpec >& index, unsigned int )
+    {
+      create_index( index );
+    }
+
+  /**
+   *  @brief  Build an index of a set of reads to be traversed from left to right.
+   *
+   *  @param  reads The set of reads.
+   *  @return The index which owns a copy of the reads if it is built on reversed reads.
+   *
+   *  The top-down iterators of FM indexes extend their representative string to the
+   *  left; so FM reads indexes are built on the reversed reads. The occurrence offsets
+   *  are then counted from the end of the reads: they are the same as the forward ones
+   *  only for the matches spanning the whole read; e.g. for the fixed-length seeds.
+   */
+  template< typename TIndex, typename TText >
+      inline TIndex
+    make_reads_index( TText const& reads )
+    {
+      if constexpr ( is_fmindex< typename seqan2::Spec< TIndex >::Type >::value ) {
+        TIndex index;
+        auto& text = indexText( index );
+        text = reads;
+        reverse( text );
+        return index;
+      }
+      else return TIndex( reads );
+    }
+
+  /**
+   *  @brief  Create the q-gram lookup table fibre of the index.
+   *
+   *  Only FM indexes support q-gram tables.
+   */
+  template< typename TText, typename TIndexSpec >
+      inline void
+    create_qgram_table( seqan2::Index< TText, TIndexSpec >&, unsigned int q,
+        unsigned int=1 )
+    {
+      if ( q != 0 ) throw std::runtime_error( "q-gram table is only supported by FM index" );
+    }
+
+  template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens >
+      inline void
+    create_qgram_table( seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >& index,
+        unsigned int q, unsigned int nof_threads=1 )
+    {
+      index.create_qgram_table( q, nof_threads );
     }
 
   template< typename TText, typename TIndexSpec >
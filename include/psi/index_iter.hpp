@@ -22,6 +22,10 @@
 #include <functional>
 #include <algorithm>
 #include <type_traits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <exception>
 
 #include "index.hpp"
 #include "seed.hpp"
@@ -247,6 +251,111 @@ namespace psi {
       return goDown( iterator, c );
     }
 
+  /**
+   *  @brief  Get the length of q-grams in the q-gram table of the underlying index.
+   *
+   *  @return zero if the index has no q-gram table.
+   */
+  template< typename TIndex, typename TSpec >
+      inline unsigned int
+    qgram_length( IndexIter< TIndex, TopDownFine< TSpec > > const& )
+    {
+      return 0;
+    }
+
+  template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens, typename TSpec >
+      inline unsigned int
+    qgram_length( IndexIter< seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >, TopDownFine< TSpec > > const& iterator )
+    {
+      return iterator.qgram_length();
+    }
+
+  /**
+   *  @brief  Go down along a packed DNA q-gram (see `QGramTable`).
+   *
+   *  @param  iterator The iterator.
+   *  @param  code The packed q-gram.
+   *  @param  q The length of the q-gram.
+   *  @return `true` if the iterator went down along the whole q-gram; otherwise the
+   *          iterator might have partially gone down.
+   *
+   *  It goes down one character at a time by default.
+   */
+  template< typename TIndex, typename TSpec >
+      inline bool
+    go_down_qgram( IndexIter< TIndex, TopDownFine< TSpec > >& iterator, std::uint64_t code,
+        unsigned int q )
+    {
+      static const char alphabet[] = { 'A', 'C', 'G', 'T' };
+      for ( unsigned int i = q; i > 0; --i ) {
+        if ( !go_down( iterator, alphabet[ ( code >> ( 2 * ( i - 1 ) ) ) & 3 ] ) ) return false;
+      }
+      return true;
+    }
+
+  /**
+   *  @brief  Go down along a packed DNA q-gram using the q-gram table if possible.
+   *
+   *  It jumps in one step if the iterator is at the root and the index has a q-gram
+   *  table of length `q`. The iterator is not changed if the q-gram does not occur
+   *  in this case.
+   */
+  template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens, typename TSpec >
+      inline bool
+    go_down_qgram( IndexIter< seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >, TopDownFine< TSpec > >& iterator,
+        std::uint64_t code, unsigned int q )
+    {
+      static const char alphabet[] = { 'A', 'C', 'G', 'T' };
+      if ( q != 0 && q == iterator.qgram_length() && rep_length( iterator ) == 0 ) {
+        return iterator.go_down_qgram( code ) != 0;
+      }
+      for ( unsigned int i = q; i > 0; --i ) {
+        if ( !go_down( iterator, alphabet[ ( code >> ( 2 * ( i - 1 ) ) ) & 3 ] ) ) return false;
+      }
+      return true;
+    }
+
+  /**
+   *  @brief  Prefetch the memory blocks touched by going down the iterator.
+   *
+   *  It is no-op by default.
+   */
+  template< typename TIndex, typename TSpec >
+      inline void
+    prefetch( IndexIter< TIndex, TopDownFine< TSpec > > const& )
+    { /* NOOP */ }
+
+  template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens, typename TSpec >
+      inline void
+    prefetch( IndexIter< seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >, TopDownFine< TSpec > > const& iterator )
+    {
+      iterator.prefetch();
+    }
+
+  /**
+   *  @brief  Go down a group of independent iterators by one character each.
+   *
+   *  @param  iters Pointers to the iterators.
+   *  @param  chars The character by which the corresponding iterator goes down.
+   *  @param  found Whether the corresponding iterator went down [out].
+   *  @param  n The number of iterators.
+   *
+   *  The iterators are processed in groups of `GO_DOWN_BATCH_SIZE`. All iterators in a
+   *  group prefetch their memory blocks before any of them goes down; so the cache
+   *  misses of independent iterators overlap instead of being paid one by one.
+   */
+  template< typename TIter, typename TChar, typename TFlag >
+      inline void
+    go_down_batch( TIter* const* iters, TChar const* chars, TFlag* found, std::size_t n )
+    {
+      constexpr const std::size_t GO_DOWN_BATCH_SIZE = 16;
+      for ( std::size_t s = 0; s < n; s += GO_DOWN_BATCH_SIZE ) {
+        std::size_t e = std::min( s + GO_DOWN_BATCH_SIZE, n );
+        for ( std::size_t i = s; i < e; ++i ) prefetch( *iters[ i ] );
+        for ( std::size_t i = s; i < e; ++i ) found[ i ] = go_down( *iters[ i ], chars[ i ] );
+      }
+    }
+
   /**
    *  @brief  Go down when iterator points to the given character on an edge.
    *
@@ -625,6 +734,45 @@ namespace psi {
       return getOccurrences( iter, seqan2::Rev() );
     }
 
+  /**
+   *  @brief  Call `callback` for each occurrence of the iterator's representative.
+   *
+   *  Unlike `get_occurrences_stree`, it does not necessarily allocate: the FM index
+   *  iterators locate the occurrences in batch into the thread's scratch memory.
+   */
+  template< typename TIndex, typename TIterSpec, typename TCallback >
+      inline void
+    for_each_occurrence_stree( const seqan2::Iter< TIndex, TIterSpec >& iter, TCallback callback )
+    {
+      using seqan2::length;
+
+      auto const& occs = get_occurrences_stree( iter );
+      for ( std::size_t i = 0; i < length( occs ); ++i ) callback( occs[ i ] );
+    }
+
+  template< typename TText, class TWT, uint32_t TDens, uint32_t TInvDens, typename TSpec,
+            typename TCallback >
+      inline void
+    for_each_occurrence_stree(
+        const seqan2::Iter< seqan2::Index< TText, FMIndex< TWT, TDens, TInvDens > >, seqan2::TopDown< TSpec > >& iter,
+        TCallback callback )
+    {
+      iter.for_each_occurrence( callback );
+    }
+
+  /**
+   *  @brief  Call `callback` for each occurrence of the iterator's representative.
+   *
+   *  See `for_each_occurrence_stree`.
+   */
+  template< typename TIndex, typename TSpec, typename TCallback >
+      inline void
+    for_each_occurrence( const IndexIter< TIndex, TopDownFine< TSpec > >& iterator,
+        TCallback callback )
+    {
+      for_each_occurrence_stree( iterator.get_iter_(), callback );
+    }
+
   /* END OF Index interator interface functions  --------------------------------- */
 
   template< typename TIter >
@@ -734,15 +882,15 @@ namespace psi {
 
       using seqan2::length;
 
-      const auto& occurrences1 = get_occurrences_stree( itr1 );
       const auto& occurrences2 = get_occurrences_stree( itr2 );
+      auto gocc = countOccurrences( itr1 );
 
-      for ( unsigned int i = 0; i < length( occurrences1 ); ++i ) {
-        for ( unsigned int j = 0; j < length( occurrences2 ); ++j ) {
-          auto oc = _map_occurrences( occurrences1[i], k, TPathDir() );
-          _add_seed( oc, occurrences2[j], rec1, rec2, k, length( occurrences1 ), callback );
-        }
-      }
+      for_each_occurrence_stree( itr1, [&]( auto const& occ1 ) {
+          auto oc = _map_occurrences( occ1, k, TPathDir() );
+          for ( unsigned int j = 0; j < length( occurrences2 ); ++j ) {
+            _add_seed( oc, occurrences2[j], rec1, rec2, k, gocc, callback );
+          }
+        } );
     }
 
   template< typename TIter1, typename TIter2, typename TRecords1, typename TRecords2, typename TCallback >
@@ -805,6 +953,66 @@ namespace psi {
       while ( rlen-- != cp_len ) go_up( itr );
     }
 
+  /**
+   *  @brief  Enumerate all k-mers sharing the first `minlen` characters with `seed`.
+   *
+   *  @param  fst_itr The iterator of the first index positioned at the prefix.
+   *  @param  snd_itr The iterator of the second index positioned at the prefix.
+   *  @param  seed The current k-mer (see `with_kmer`); its first `minlen` characters
+   *               are fixed.
+   *  @param  minlen The length of the fixed prefix.
+   *
+   *  Both iterators are walked in lockstep in lexicographical order of k-mers. The
+   *  iterators never go above the prefix; so the enumeration is restricted to the
+   *  subtree rooted at the prefix.
+   */
+  template< typename TIter1, typename TIter2, typename TRecords1, typename TRecords2,
+            typename TKmer, typename TCallback, typename TStats >
+      inline void
+    _kmer_exact_matches_under_prefix( TIter1& fst_itr, TIter2& snd_itr,
+        const TRecords1* rec1,
+        const TRecords2* rec2,
+        unsigned int k,
+        TKmer& seed,
+        unsigned int minlen,
+        TCallback& callback,
+        unsigned int gocc_threshold,
+        TStats& collect_stats )
+    {
+      /* The first index jumps over its first `q` characters using its q-gram table:
+       * it waits at the root until the second one matches the q-gram. */
+      unsigned int q = qgram_length( fst_itr );
+      if ( q <= minlen || q > k ) q = 0;
+
+      unsigned int plen = minlen;
+      do {
+        if ( plen < q ) {
+          if ( rep_length( fst_itr ) != 0 ) go_root( fst_itr );
+        }
+        else upto_prefix( fst_itr, plen );
+        upto_prefix( snd_itr, plen );
+        for ( ; plen < k; ++plen ) {
+          if ( plen < q ) {
+            if ( !go_down( snd_itr, seed[plen] ) ) break;
+            if ( plen + 1 == q &&
+                 !go_down_qgram( fst_itr, kmer_prefix_code( seed, q ), q ) ) break;
+            continue;
+          }
+          if ( !go_down( fst_itr, seed[plen] ) ) break;
+          if ( !go_down( snd_itr, seed[plen] ) ) break;
+        }
+        if ( plen == k ) {
+          auto count = count_occurrences( fst_itr );
+          if ( count <= gocc_threshold ) {
+            collect_stats( count, false );
+            _add_occurrences( fst_itr.get_iter_(), snd_itr.get_iter_(), rec1, rec2, k, callback );
+          } else collect_stats( count, true );
+          --plen;
+        }
+        plen = increment_kmer( seed, plen, true );
+      } while ( plen + 1 > minlen );
+    }
+
   template< typename TIndex1, typename TIndex2, typename TRecords1, typename TRecords2,
             typename TCallback, typename TStats = std::function< void( std::size_t, bool ) > >
       inline void
@@ -828,27 +1036,118 @@ namespace psi {
         gocc_threshold = std::numeric_limits< decltype( gocc_threshold ) >::max();
       }
 
-      seqan2::DnaString seed;                   // seed = A..(k)..A
-      for ( unsigned int i = 0; i < k; ++i ) appendValue( seed, 'A' );
+      with_kmer( k, [&]( auto& seed ) {         // seed = A..(k)..A
+          _kmer_exact_matches_under_prefix( fst_itr, snd_itr, rec1, rec2, k, seed, 0,
+                                            callback, gocc_threshold, collect_stats );
+        } );
+    }
 
-      unsigned int plen = 0;
-      do {
-        upto_prefix( fst_itr, plen );
-        upto_prefix( snd_itr, plen );
-        for ( ; plen < k; ++plen ) {
-          if ( !go_down( fst_itr, seed[plen] ) ) break;
-          if ( !go_down( snd_itr, seed[plen] ) ) break;
+  /**
+   *  @brief  Find exact k-mer matches between two indices using multiple threads.
+   *
+   *  @param  fst The first index (path index).
+   *  @param  snd The second index (reads index).
+   *  @param  callbacks The per-thread callbacks reporting the matches.
+   *  @param  collect_stats The per-thread callbacks collecting stats.
+   *  @param  plen The length of the prefixes partitioning the k-mer space [optional].
+   *
+   *  The k-mer space is partitioned by the first `plen` characters of the k-mers. Each
+   *  prefix is a task which enumerates all k-mers sharing that prefix by its own pair
+   *  of iterators positioned at the prefix; tasks are fetched by the threads from a
+   *  shared counter. The number of threads is the number of callbacks, and the i-th
+   *  thread only calls `callbacks[ i ]` and `collect_stats[ i ]`. If `plen` is zero, it
+   *  is chosen such that there are a few times more tasks than threads.
+   *
+   *  NOTE: Both indices should be fully constructed beforehand (if they are lazy), so
+   *  that they can be traversed concurrently.
+   */
+  template< typename TIndex1, typename TIndex2, typename TRecords1, typename TRecords2,
+            typename TCallback, typename TStats >
+      inline void
+    kmer_exact_matches( TIndex1& fst, TIndex2& snd,
+        const TRecords1* rec1,
+        const TRecords2* rec2,
+        unsigned int k,
+        std::vector< TCallback >& callbacks,
+        unsigned int gocc_threshold,
+        std::vector< TStats >& collect_stats,
+        unsigned int plen=0 )
+    {
+      typedef IndexIter< TIndex1, TopDownFine< seqan2::ParentLinks<> > > TIter1;
+      typedef IndexIter< TIndex2, TopDownFine< seqan2::ParentLinks<> > > TIter2;
+      typedef seqan2::Dna TAlphabet;
+
+      static_assert( ( is_fmindex< typename seqan2::Spec< TIndex1 >::Type >::value &&
+            std::is_same< typename Direction< TRecords1 >::Type, Reversed >::value ) ||
+          ( !is_fmindex< typename seqan2::Spec< TIndex1 >::Type >::value &&
+            std::is_same< typename Direction< TRecords1 >::Type, Forward >::value ),
+          "The paths direction and the path index used are not compatible." );
+
+      constexpr const unsigned int TASKS_PER_THREAD = 16;
+      unsigned int nof_threads = callbacks.size();
+      assert( collect_stats.size() >= nof_threads );
+
+      if ( k == 0 || nof_threads == 0 ) return;
+      if ( gocc_threshold == 0 ) {
+        gocc_threshold = std::numeric_limits< decltype( gocc_threshold ) >::max();
+      }
+
+      unsigned int sigma = seqan2::ValueSize< TAlphabet >::VALUE;
+      if ( plen == 0 ) {
+        std::size_t nof_tasks = 1;
+        while ( nof_tasks < nof_threads * TASKS_PER_THREAD ) {
+          nof_tasks *= sigma;
+          ++plen;
         }
-        if ( plen == k ) {
-          auto count = count_occurrences( fst_itr );
-          if ( count <= gocc_threshold ) {
-            collect_stats( count, false );
-            _add_occurrences( fst_itr.get_iter_(), snd_itr.get_iter_(), rec1, rec2, k, callback );
-          } else collect_stats( count, true );
-          --plen;
+      }
+      plen = std::min( plen, k - 1 );
+      std::size_t nof_tasks = 1;
+      for ( unsigned int i = 0; i < plen; ++i ) nof_tasks *= sigma;
+
+      std::atomic< std::size_t > next_task( 0 );
+      std::exception_ptr eptr = nullptr;
+      std::mutex eptr_lock;
+
+      auto worker = [&]( unsigned int tidx ) {
+        try {
+          with_kmer( k, [&]( auto& seed ) {
+              std::size_t task;
+              while ( ( task = next_task++ ) < nof_tasks ) {
+                /* seed = prefix + A..(k-plen)..A, where prefix is the packed `task`. */
+                assign_kmer_prefix( seed, task, plen );
+
+                TIter1 fst_itr( fst );
+                TIter2 snd_itr( snd );
+                if ( !go_down_qgram( snd_itr, task, plen ) ) continue;
+                /* Otherwise, the first iterator is moved in the enumeration (see
+                 * `_kmer_exact_matches_under_prefix`). A q-gram table longer than the
+                 * k-mers is not used; i.e. the prefix is descended character-wise. */
+                unsigned int q = qgram_length( fst_itr );
+                if ( q > k ) q = 0;
+                if ( q <= plen ) {
+                  if ( !go_down_qgram( fst_itr, task >> ( 2 * ( plen - q ) ), q ) ) continue;
+                  unsigned int i = q;
+                  for ( ; i < plen; ++i ) if ( !go_down( fst_itr, seed[ i ] ) ) break;
+                  if ( i < plen ) continue;  // no k-mer with this prefix in the first index
+                }
+                _kmer_exact_matches_under_prefix( fst_itr, snd_itr, rec1, rec2, k, seed, plen,
+                                                  callbacks[ tidx ], gocc_threshold,
+                                                  collect_stats[ tidx ] );
+              }
+            } );
         }
-        plen = increment_kmer( seed, plen, true );
-      } while ( plen + 1 > 0 );
+        catch ( ... ) {
+          next_task = nof_tasks;  // stop other threads
+          std::lock_guard< std::mutex > lock( eptr_lock );
+          if ( !eptr ) eptr = std::current_exception();
+        }
+      };
+
+      std::vector< std::thread > workers;
+      workers.reserve( nof_threads );
+      for ( unsigned int i = 0; i < nof_threads; ++i ) workers.emplace_back( worker, i );
+      for ( auto& w : workers ) w.join();
+      if ( eptr ) std::rethrow_exception( eptr );
     }
 
   template< typename TString, typename TIndex, typename TSpec, typename TRecords, typename TCallback >
@@ -869,27 +1168,40 @@ namespace psi {
       }
       if ( max_mem == 0 ) max_mem = std::numeric_limits< decltype( max_mem ) >::max();
 
+      /* Jump over the first `q` characters of each MEM candidate by the q-gram table
+       * when no hit could be reported before reaching depth `q`. */
+      unsigned int q = qgram_length( idx_itr );
+      if ( q > minlen ) q = 0;
+
       unsigned int start = 0;
       unsigned int plen = 0;
       bool has_hit = false;
       std::size_t nof_hits = 0;
       while( start + plen < pattern.size() ) {
+        if ( plen == 0 && q != 0 && start + q < pattern.size() ) {
+          std::uint64_t code = 0;
+          unsigned int i = 0;
+          for ( ; i < q; ++i ) {
+            auto c = pattern[ start + i ];
+            if ( c == 'N' ) break;
+            code = ( code << 2 ) | ordValue( seqan2::Dna( c ) );
+          }
+          if ( i == q && go_down_qgram( idx_itr, code, q ) ) plen = q;
+        }
         if ( plen >= minlen && count_occurrences( idx_itr ) <= gocc_threshold ) {
-          using seqan2::length;
-
           has_hit = true;
-          auto const& occs = get_occurrences( idx_itr );
+          auto gocc = count_occurrences( idx_itr );
           Seed<> hit;
-          for ( unsigned int i = 0; i < length( occs ); ++i ) {
-            auto oc = _map_occurrences( occs[i], plen, TPathDir() );
-            hit.node_id = position_to_id( *pathset, oc );
-            hit.node_offset = position_to_offset( *pathset, oc );
-            hit.read_offset = start;
-            hit.match_len = plen;
-            hit.gocc = length( occs );
-            callback( hit );
-            ++nof_hits;
-          }
+          for_each_occurrence( idx_itr, [&]( auto const& occ ) {
+              auto oc = _map_occurrences( occ, plen, TPathDir() );
+              hit.node_id = position_to_id( *pathset, oc );
+              hit.node_offset = position_to_offset( *pathset, oc );
+              hit.read_offset = start;
+              hit.match_len = plen;
+              hit.gocc = gocc;
+              callback( hit );
+              ++nof_hits;
+            } );
           if ( nof_hits >= max_mem ) break;
         }
         if ( has_hit /*|| plen > context*/ ||
@@ -905,6 +1217,169 @@ namespace psi {
       }
     }
 
+  /**
+   *  @brief  A match of a pattern substring with its bidirectional index iterator.
+   */
+  template< typename TIter >
+    struct BiMatch {
+      TIter iter;          /**< @brief Iterator pointing to the matched substring. */
+      unsigned int begin;  /**< @brief Start position of the match in the pattern. */
+      unsigned int end;    /**< @brief End position (exclusive) of the match in the pattern. */
+    };
+
+  /**
+   *  @brief  Find all super-maximal exact matches (SMEMs) covering a pattern position.
+   *
+   *  @param  pattern The pattern.
+   *  @param  root The bidirectional index iterator at the root.
+   *  @param  x The pattern position.
+   *  @param  minlen The minimum length of the reported SMEMs.
+   *  @param  prev A scratch buffer.
+   *  @param  curr Another scratch buffer.
+   *  @param  callback The callback called for each SMEM by a `BiMatch`.
+   *  @return The end position of the longest match starting at `x`.
+   *
+   *  It first extends the match starting at `x` to the right and keeps the matches
+   *  whose number of occurrences differ. Then, all of them are extended to the left in
+   *  lockstep; a match which cannot be extended is an SMEM if no longer match has
+   *  survived the same step and it is not contained in the previously reported one
+   *  (see Li, Bioinformatics 2012).
+   */
+  template< typename TString, typename TIter, typename TCallback >
+      inline unsigned int
+    _find_smems_at( TString const& pattern, TIter const& root, unsigned int x,
+        unsigned int minlen, std::vector< BiMatch< TIter > >& prev,
+        std::vector< BiMatch< TIter > >& curr, TCallback& callback )
+    {
+      using seqan2::length;
+
+      unsigned int len = length( pattern );
+      if ( pattern[ x ] == 'N' ) return x + 1;
+
+      curr.clear();
+      BiMatch< TIter > m{ root, x, x + 1 };
+      if ( !goDown( m.iter, pattern[ x ], seqan2::Fwd() ) ) return x + 1;
+      for ( unsigned int i = x + 1; i < len && pattern[ i ] != 'N'; ++i ) {
+        BiMatch< TIter > ext = m;
+        if ( !goDown( ext.iter, pattern[ i ], seqan2::Fwd() ) ) break;
+        if ( countOccurrences( ext.iter ) != countOccurrences( m.iter ) ) curr.push_back( m );
+        ext.end = i + 1;
+        m = std::move( ext );
+      }
+      curr.push_back( std::move( m ) );
+      std::reverse( curr.begin(), curr.end() );  // the longest first
+      unsigned int next = curr.front().end;
+
+      unsigned int last_begin = std::numeric_limits< unsigned int >::max();
+      for ( unsigned int i = x; !curr.empty(); --i ) {
+        std::swap( prev, curr );
+        curr.clear();
+        bool extendable = ( i != 0 && pattern[ i - 1 ] != 'N' );
+        for ( auto& p : prev ) {
+          BiMatch< TIter > ext = p;
+          if ( !extendable || !goDown( ext.iter, pattern[ i - 1 ], seqan2::Rev() ) ) {
+            if ( curr.empty() && p.begin < last_begin ) {
+              last_begin = p.begin;
+              if ( p.end - p.begin >= minlen ) callback( p );
+            }
+          }
+          else if ( curr.empty() ||
+                    countOccurrences( ext.iter ) != countOccurrences( curr.back().iter ) ) {
+            ext.begin = i - 1;
+            curr.push_back( std::move( ext ) );
+          }
+        }
+        if ( i == 0 ) break;
+      }
+      return next;
+    }
+
+  /**
+   *  @brief  Find all super-maximal exact matches (SMEMs) of a pattern.
+   *
+   *  @param  pattern The pattern.
+   *  @param  index The bidirectional index of the text.
+   *  @param  minlen The minimum length of the reported SMEMs.
+   *  @param  callback The callback called for each SMEM by a `BiMatch`.
+   *
+   *  An SMEM is an exact match that is not contained in any other exact match of the
+   *  pattern. The pattern is scanned once from left to right by jumping over the
+   *  longest match at each step; so all SMEMs are reported (including overlapping
+   *  ones) while each character is extended a bounded number of times in practice.
+   *  'N' characters never match.
+   */
+  template< typename TString, typename TText, typename TCallback >
+      inline void
+    find_smems( TString const& pattern, seqan2::Index< TText, CBiFMIndex >& index,
+        unsigned int minlen, TCallback callback )
+    {
+      typedef typename seqan2::Iterator< seqan2::Index< TText, CBiFMIndex >, seqan2::TopDown<> >::Type TIter;
+
+      using seqan2::length;
+
+      TIter root( index );
+      std::vector< BiMatch< TIter > > prev;
+      std::vector< BiMatch< TIter > > curr;
+      unsigned int x = 0;
+      while ( x < length( pattern ) ) {
+        x = _find_smems_at( pattern, root, x, minlen, prev, curr, callback );
+      }
+    }
+
+  /**
+   *  @brief  Find super-maximal exact matches of a pattern on the paths.
+   *
+   *  @param  pattern The pattern.
+   *  @param  index The bidirectional index of the forward path sequences.
+   *  @param  pathset The paths set; its sequences should be in forward direction.
+   *  @param  minlen The minimum length of the reported matches.
+   *  @param  callback The callback called for each occurrence by a `Seed`.
+   *  @param  gocc_threshold Skip matches occurring more than this [default: no limit].
+   *  @param  max_mem Stop after reporting this many occurrences [default: no limit].
+   *
+   *  Unlike the unidirectional version, it reports overlapping matches as well.
+   */
+  template< typename TString, typename TText, typename TRecords, typename TCallback >
+      inline void
+    find_mems( TString const& pattern,
+               seqan2::Index< TText, CBiFMIndex >& index,
+               const TRecords* pathset,
+               unsigned int minlen,
+               TCallback callback,
+               unsigned int gocc_threshold = 0,
+               unsigned int max_mem = 0 )
+    {
+      static_assert( std::is_same< typename Direction< TRecords >::Type, Forward >::value,
+          "The paths should be forward sequences." );
+
+      if ( gocc_threshold == 0 ) {
+        gocc_threshold = std::numeric_limits< decltype( gocc_threshold ) >::max();
+      }
+      if ( max_mem == 0 ) max_mem = std::numeric_limits< decltype( max_mem ) >::max();
+
+      using seqan2::length;
+
+      std::size_t nof_hits = 0;
+      /* The SMEMs are still enumerated after reaching `max_mem`; they are cheap compared
+       * to locating the occurrences. */
+      find_smems( pattern, index, minlen, [&]( auto const& mem ) {
+          if ( nof_hits >= max_mem ) return;
+          auto gocc = countOccurrences( mem.iter );
+          if ( gocc > gocc_threshold ) return;
+          auto const& occs = getOccurrences( mem.iter, seqan2::Fwd() );
+          Seed<> hit;
+          for ( unsigned int i = 0; i < length( occs ) && nof_hits < max_mem; ++i ) {
+            hit.node_id = position_to_id( *pathset, occs[i] );
+            hit.node_offset = position_to_offset( *pathset, occs[i] );
+            hit.read_offset = mem.begin;
+            hit.match_len = mem.end - mem.begin;
+            hit.gocc = gocc;
+            callback( hit );
+            ++nof_hits;
+          }
+        } );
+    }
+
   template< typename TIndex, typename TRecords1, typename TRecordsIter, typename TCallback >
       inline void
     kmer_exact_matches( TIndex& paths_index, const TRecords1* pathset,
@@ -0,0 +1,562 @@
+/**
+ *    @file  kmerindex.hpp
+ *   @brief  Sorted packed k-mer array index.
+ *
+ *  This header file contains an index of a set of fixed-length strings (e.g. seeds)
+ *  implemented as a sorted array of 2-bit packed k-mers providing SeqAn top-down
+ *  iterator interface.
+ *
+ *  @author  Ali Ghaffaari (\@cartoonist), <ali.ghaffaari@mpi-inf.mpg.de>
+ *
+ *  @internal
+ *       Created:  Fri Oct 16, 2026  10:12
+ *  Organization:  Max-Planck-Institut fuer Informatik
+ *     Copyright:  Copyright (c) 2026, Ali Ghaffaari
+ *
+ *  This source code is released under the terms of the MIT License.
+ *  See LICENSE file for more information.
+ */
+
+#ifndef  PSI_KMERINDEX_HPP__
+#define  PSI_KMERINDEX_HPP__
+
+#include <cstdint>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#include <seqan/index.h>
+
+#include "fmindex.hpp"
+
+
+namespace psi {
+  /**
+   *  @brief  Index specification tag for a sorted array of packed k-mers.
+   *
+   *  The indexed strings should have the same length `k <= 32`; e.g. the seeds of a
+   *  reads chunk. Each string is packed into a 2-bit k-mer and the distinct k-mers
+   *  are sorted each with the list of its occurrences. Its top-down iterator narrows
+   *  down a range of the sorted k-mers by one character at a time; so it behaves as
+   *  a trie of depth `k` whose nodes are the ranges. The strings containing non-ACGT
+   *  characters are not indexed since they never match.
+   */
+  template< typename TSpec = void >
+    struct KmerIndex;
+}  /* --- end of namespace psi --- */
+
+namespace seqan2 {
+  template< typename TText, typename TSpec >
+    class Index< TText, psi::KmerIndex< TSpec > > {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef TText text_type;
+        typedef std::uint64_t kmer_type;
+        typedef std::size_t savalue_type;
+        typedef std::pair< savalue_type, savalue_type > range_type;  /**< @brief Closed range. */
+        typedef typename SAValue< TText >::Type pos_type;
+        typedef String< pos_type > occs_type;
+        typedef typename Infix< occs_type const >::Type occs_infix_type;
+        typedef typename Value< typename Value< TText >::Type >::Type char_type;
+        /* ====================  CONSTANTS     ======================================= */
+        constexpr static const unsigned int MAX_K = 32;
+        constexpr static range_type EMPTY_RANGE = { 1, 0 };
+        /* ====================  LIFECYCLE     ======================================= */
+        Index( ) : k( 0 ) { }
+
+        /**
+         *  @brief  Build the index of the given strings.
+         *
+         *  Unlike SeqAn indexes, it is built on construction and keeps no reference to
+         *  the text.
+         */
+        Index( TText const& text ) : Index( )
+        {
+          this->build( text );
+        }
+        /* ====================  ACCESSORS     ======================================= */
+          inline unsigned int
+        get_k( ) const
+        {
+          return this->k;
+        }
+        /* ====================  METHODS       ======================================= */
+        /**
+         *  @brief  The number of distinct k-mers.
+         */
+          inline savalue_type
+        size( ) const
+        {
+          return this->kmers.size();
+        }
+
+          inline bool
+        empty( ) const
+        {
+          return this->size() == 0;
+        }
+
+          inline kmer_type
+        get_kmer( savalue_type i ) const
+        {
+          return this->kmers[ i ];
+        }
+
+        /**
+         *  @brief  Get the rank of the character at `depth` of a k-mer in the alphabet.
+         */
+          inline unsigned int
+        char_at( kmer_type kmer, unsigned int depth ) const
+        {
+          assert( depth < this->k );
+          return ( kmer >> ( 2 * ( this->k - depth - 1 ) ) ) & 3;
+        }
+
+          inline range_type
+        root_range( ) const
+        {
+          if ( this->empty() ) return EMPTY_RANGE;
+          return range_type( 0, this->size() - 1 );
+        }
+
+        /**
+         *  @brief  Narrow down a range of k-mers sharing their first `depth` characters.
+         *
+         *  @param  r The range of the k-mers sharing a prefix of length `depth`.
+         *  @param  depth The length of the shared prefix.
+         *  @param  c The rank of the next character in the alphabet.
+         *  @return The sub-range of the k-mers whose next character is `c`.
+         *
+         *  The next characters of the k-mers in the range are sorted; so the sub-range
+         *  is found by binary search.
+         */
+          inline range_type
+        child( range_type r, unsigned int depth, unsigned int c ) const
+        {
+          if ( r.first > r.second || depth >= this->k ) return EMPTY_RANGE;
+          unsigned int shift = 2 * ( this->k - depth - 1 );
+          auto first = this->kmers.begin() + r.first;
+          auto last = this->kmers.begin() + r.second + 1;
+          auto lb = std::lower_bound( first, last, c,
+              [shift]( kmer_type kmer, unsigned int value ) {
+                return ( ( kmer >> shift ) & 3 ) < value;
+              } );
+          auto ub = std::upper_bound( lb, last, c,
+              [shift]( unsigned int value, kmer_type kmer ) {
+                return value < ( ( kmer >> shift ) & 3 );
+              } );
+          if ( lb == ub ) return EMPTY_RANGE;
+          return range_type( lb - this->kmers.begin(), ub - this->kmers.begin() - 1 );
+        }
+
+        /**
+         *  @brief  Widen a range of k-mers sharing their first `depth` characters.
+         *
+         *  @param  r The non-empty range of the k-mers sharing a prefix of length `depth`.
+         *  @param  depth The length of the shared prefix.
+         *  @return The range of the k-mers sharing the first `depth - 1` characters.
+         *
+         *  It is the inverse of `child`: the k-mers having the shorter prefix are
+         *  consecutive; so the range is found by binary search on the whole array.
+         */
+          inline range_type
+        parent( range_type r, unsigned int depth ) const
+        {
+          assert( r.first <= r.second && depth <= this->k );
+          if ( depth <= 1 ) return this->root_range();
+          unsigned int shift = 2 * ( this->k - depth + 1 );
+          kmer_type prefix = this->kmers[ r.first ] >> shift;
+          auto lb = std::lower_bound( this->kmers.begin(), this->kmers.begin() + r.first, prefix,
+              [shift]( kmer_type kmer, kmer_type value ) {
+                return ( kmer >> shift ) < value;
+              } );
+          auto ub = std::upper_bound( this->kmers.begin() + r.second + 1, this->kmers.end(), prefix,
+              [shift]( kmer_type value, kmer_type kmer ) {
+                return value < ( kmer >> shift );
+              } );
+          return range_type( lb - this->kmers.begin(), ub - this->kmers.begin() - 1 );
+        }
+
+        /**
+         *  @brief  The number of occurrences of the k-mers in the range.
+         */
+          inline savalue_type
+        count( range_type r ) const
+        {
+          if ( r.first > r.second ) return 0;
+          return this->bounds[ r.second + 1 ] - this->bounds[ r.first ];
+        }
+
+        /**
+         *  @brief  The occurrences of the k-mers in the range without copying.
+         */
+          inline occs_infix_type
+        occurrences( range_type r ) const
+        {
+          if ( r.first > r.second ) return infix( this->occs, 0, 0 );
+          return infix( this->occs, this->bounds[ r.first ], this->bounds[ r.second + 1 ] );
+        }
+
+          inline void
+        build( TText const& text )
+        {
+          this->clear();
+          if ( length( text ) == 0 ) return;
+
+          this->k = length( text[ 0 ] );
+          if ( this->k == 0 || this->k > MAX_K ) {
+            throw std::runtime_error( "k-mer index only supports string lengths of 1 to " +
+                                      std::to_string( MAX_K ) );
+          }
+
+          std::vector< std::pair< kmer_type, savalue_type > > pairs;
+          pairs.reserve( length( text ) );
+          for ( savalue_type i = 0; i < length( text ); ++i ) {
+            auto const& str = text[ i ];
+            if ( length( str ) != this->k ) {
+              throw std::runtime_error( "k-mer index requires strings of the same length" );
+            }
+            kmer_type kmer = 0;
+            unsigned int j = 0;
+            for ( ; j < this->k; ++j ) {
+              unsigned int c = ordValue( str[ j ] );
+              if ( c > 3 ) break;
+              kmer = ( kmer << 2 ) | c;
+            }
+            if ( j == this->k ) pairs.emplace_back( kmer, i );
+          }
+          this->build( this->k, pairs );
+        }
+
+        /**
+         *  @brief  Build the index of packed k-mers each paired with an occurrence id.
+         *
+         *  @param  kmer_len The length of the k-mers.
+         *  @param  pairs The packed k-mers and their ids; it is sorted in place (if not
+         *               already sorted).
+         *
+         *  The occurrence of the pair `(kmer, id)` is `pos_type( id, 0 )`. The same pair
+         *  is indexed once.
+         */
+          inline void
+        build( unsigned int kmer_len,
+            std::vector< std::pair< kmer_type, savalue_type > >& pairs )
+        {
+          this->clear();
+          if ( kmer_len == 0 || kmer_len > MAX_K ) {
+            throw std::runtime_error( "k-mer index only supports string lengths of 1 to " +
+                                      std::to_string( MAX_K ) );
+          }
+          this->k = kmer_len;
+
+          if ( !std::is_sorted( pairs.begin(), pairs.end() ) ) {
+            std::sort( pairs.begin(), pairs.end() );
+          }
+          pairs.erase( std::unique( pairs.begin(), pairs.end() ), pairs.end() );
+
+          resize( this->occs, pairs.size(), Exact() );
+          for ( std::size_t i = 0; i < pairs.size(); ++i ) {
+            if ( i == 0 || pairs[ i ].first != pairs[ i - 1 ].first ) {
+              this->kmers.push_back( pairs[ i ].first );
+              this->bounds.push_back( i );
+            }
+            this->occs[ i ] = pos_type( pairs[ i ].second, 0 );
+          }
+          this->bounds.push_back( pairs.size() );
+          this->kmers.shrink_to_fit();
+          this->bounds.shrink_to_fit();
+        }
+
+          inline void
+        clear( )
+        {
+          this->k = 0;
+          this->kmers.clear();
+          this->bounds.clear();
+          seqan2::clear( this->occs );
+        }
+
+          inline std::size_t
+        size_in_bytes( ) const
+        {
+          return this->kmers.size() * sizeof( kmer_type ) +
+              this->bounds.size() * sizeof( savalue_type ) +
+              length( this->occs ) * sizeof( pos_type );
+        }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        unsigned int k;
+        std::vector< kmer_type > kmers;      /**< @brief Sorted distinct k-mers. */
+        std::vector< savalue_type > bounds;  /**< @brief Occurrences of `kmers[i]` start at `bounds[i]`. */
+        occs_type occs;                      /**< @brief Occurrences grouped by k-mer. */
+    };
+
+  template< typename TText, typename TSpec >
+      inline void
+    clear( Index< TText, psi::KmerIndex< TSpec > >& index )
+    {
+      index.clear();
+    }
+
+  /**
+   *  @brief  Top-down iterator of the k-mer index.
+   *
+   *  Each edge has one character; going down is narrowing down the range of k-mers by
+   *  binary search and going up is widening it likewise (see `parent`). So the iterator
+   *  keeps no history and copying it never allocates.
+   */
+  template< typename TText, typename TSpec, typename TIterSpec >
+    class Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef Index< TText, psi::KmerIndex< TSpec > > index_type;
+        typedef typename index_type::savalue_type savalue_type;
+        typedef typename index_type::range_type range_type;
+        typedef typename index_type::char_type char_type;
+        typedef typename index_type::occs_infix_type occs_infix_type;
+        typedef String< char_type > string_type;
+        /* ====================  LIFECYCLE     ======================================= */
+        Iter( index_type const* i_p )
+          : index_p( i_p ), occ_cur( 1 ), occ_end( 0 ), depth( 0 )
+        {
+          this->go_root();
+        }
+
+        Iter( index_type const& i )
+          : Iter( &i ) { }
+        /* ====================  METHODS       ======================================= */
+          inline bool
+        at_end( ) const
+        {
+          return this->occ_cur > this->occ_end;
+        }
+
+          inline bool
+        is_root( ) const
+        {
+          return this->depth == 0;
+        }
+
+          inline range_type
+        range( ) const
+        {
+          return range_type( this->occ_cur, this->occ_end );
+        }
+
+          inline void
+        go_root( )
+        {
+          std::tie( this->occ_cur, this->occ_end ) = this->index_p->root_range();
+          this->depth = 0;
+        }
+
+          inline savalue_type
+        go_down( char_type c )
+        {
+          unsigned int rank = ordValue( c );
+          if ( rank > 3 ) return 0;
+          auto r = this->index_p->child( this->range(), this->depth, rank );
+          if ( r.first > r.second ) return 0;
+          std::tie( this->occ_cur, this->occ_end ) = r;
+          ++this->depth;
+          return this->count();
+        }
+
+        /**
+         *  @brief  Go down to the first child in lexicographical order.
+         */
+          inline bool
+        go_down( )
+        {
+          if ( this->at_end() || this->depth == this->index_p->get_k() ) return false;
+          auto c = this->index_p->char_at( this->index_p->get_kmer( this->occ_cur ), this->depth );
+          return this->go_down( char_type( Dna( c ) ) ) != 0;
+        }
+
+          inline bool
+        go_up( )
+        {
+          if ( this->is_root() ) return false;
+          std::tie( this->occ_cur, this->occ_end ) =
+              this->index_p->parent( this->range(), this->depth );
+          --this->depth;
+          return true;
+        }
+
+          inline bool
+        go_right( )
+        {
+          if ( this->is_root() ) return false;
+          unsigned int c = this->last_char();
+          if ( !this->go_up() ) return false;
+          for ( unsigned int next = c + 1; next < 4; ++next ) {
+            if ( this->go_down( char_type( Dna( next ) ) ) != 0 ) return true;
+          }
+          this->go_down( char_type( Dna( c ) ) );  /**< @brief cannot go right, undo go_up. */
+          return false;
+        }
+
+        /**
+         *  @brief  The rank of the last character of the representative string.
+         */
+          inline unsigned int
+        last_char( ) const
+        {
+          assert( !this->is_root() );
+          return this->index_p->char_at( this->index_p->get_kmer( this->occ_cur ), this->depth - 1 );
+        }
+
+          inline savalue_type
+        rep_length( ) const
+        {
+          return this->depth;
+        }
+
+          inline savalue_type
+        parent_edge_length( ) const
+        {
+          if ( this->is_root() ) return 0;
+          return 1;
+        }
+
+          inline string_type
+        parent_edge_label( ) const
+        {
+          string_type label;
+          if ( !this->is_root() ) appendValue( label, char_type( Dna( this->last_char() ) ) );
+          return label;
+        }
+
+          inline string_type
+        representative( ) const
+        {
+          string_type rep;
+          if ( this->at_end() ) return rep;
+          auto kmer = this->index_p->get_kmer( this->occ_cur );
+          for ( unsigned int i = 0; i < this->depth; ++i ) {
+            appendValue( rep, char_type( Dna( this->index_p->char_at( kmer, i ) ) ) );
+          }
+          return rep;
+        }
+
+          inline savalue_type
+        count( ) const
+        {
+          return this->index_p->count( this->range() );
+        }
+
+          inline occs_infix_type
+        get_occurrences( ) const
+        {
+          return this->index_p->occurrences( this->range() );
+        }
+
+          inline index_type const&
+        get_index( ) const
+        {
+          return *this->index_p;
+        }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        index_type const* index_p;
+        savalue_type occ_cur;
+        savalue_type occ_end;
+        savalue_type depth;
+    };
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline bool
+    isRoot( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.is_root();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline void
+    goRoot( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >& iter )
+    {
+      iter.go_root();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline bool
+    goDown( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >& iter,
+        typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::char_type c )
+    {
+      return iter.go_down( c ) != 0;
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline bool
+    goDown( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >& iter )
+    {
+      return iter.go_down();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline bool
+    goUp( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >& iter )
+    {
+      return iter.go_up();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline bool
+    goRight( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >& iter )
+    {
+      return iter.go_right();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::savalue_type
+    parentEdgeLength( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.parent_edge_length();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::string_type
+    parentEdgeLabel( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.parent_edge_label();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::savalue_type
+    repLength( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.rep_length();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::string_type
+    representative( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.representative();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::occs_infix_type
+    getOccurrences( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.get_occurrences();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+      inline typename Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > >::savalue_type
+    countOccurrences( Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > const& iter )
+    {
+      return iter.count();
+    }
+
+  template< typename TText, typename TSpec, typename TIterSpec >
+    struct Iterator< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > {
+      typedef Iter< Index< TText, psi::KmerIndex< TSpec > >, TopDown< TIterSpec > > Type;
+    };
+}  /* -----  end of namespace seqan2  ----- */
+
+#endif  /* --- #ifndef PSI_KMERINDEX_HPP__ --- */
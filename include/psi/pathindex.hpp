@@ -111,8 +111,7 @@ namespace psi {
         {
           this->clear();
 
-          if ( open( this->index, filepath_prefix ) &&
-              this->load_paths_set( filepath_prefix + "_paths" ) ) {
+          if ( this->load_index( filepath_prefix ) && this->load_paths( filepath_prefix ) ) {
             /* XXX: Unnecessary copy. Use `FibreText` of `this->index` directly. */
             //this->string_set = indexText( this->index );
             return true;
@@ -122,6 +121,36 @@ namespace psi {
           return false;
         }  /* -----  end of method load  ----- */
 
+        /**
+         *  @brief  Load only the index of the path index from file.
+         *
+         *  @param[in]   filepath_prefix The file path prefix of the saved path index.
+         *  @return `true` if the index is successfully loaded; otherwise `false`.
+         *
+         *  Unlike the paths set, loading the index does not require the graph; so it can
+         *  be loaded while the graph is being loaded. The path index is complete after
+         *  loading both parts by `load_index` and `load_paths`.
+         */
+          inline bool
+        load_index( const std::string& filepath_prefix )
+        {
+          return open( this->index, filepath_prefix );
+        }
+
+        /**
+         *  @brief  Load only the paths set and other attributes of the path index.
+         *
+         *  @param[in]   filepath_prefix The file path prefix of the saved path index.
+         *  @return `true` if the paths set is successfully loaded; otherwise `false`.
+         *
+         *  NOTE: The graph should be loaded beforehand.
+         */
+          inline bool
+        load_paths( const std::string& filepath_prefix )
+        {
+          return this->load_paths_set( filepath_prefix + "_paths" );
+        }
+
         /**
          *  @brief  Save the path index into file.
          *
@@ -228,19 +257,36 @@ namespace psi {
         /**
          *  @brief  Create index fibres.
          *
+         *  @param  nof_threads The number of threads used for constructing the index
+         *                      (see `psi::create_index`).
+         *
          *  Initializing the index does not create index fibres. Index fibres are
          *  generated on-demand. This function forces to create these fibres in
          *  advance.
          */
           inline void
-        create_index( )
+        create_index( unsigned int nof_threads=1 )
         {
           if ( lazy_mode ) {
             this->add_path_sequence( this->paths_set.begin(), this->paths_set.end() );
           }
-          psi::create_index( this->index );
+          psi::create_index( this->index, nof_threads );
           this->paths_set.initialize();
         }  /* -----  end of method create_index  ----- */
+
+        /**
+         *  @brief  Create the q-gram lookup table of the index (see `QGramTable`).
+         *
+         *  @param  q The length of q-grams.
+         *  @param  nof_threads The number of threads.
+         *
+         *  NOTE: The index should be created beforehand.
+         */
+          inline void
+        create_qgram_table( unsigned int q, unsigned int nof_threads=1 )
+        {
+          psi::create_qgram_table( this->index, q, nof_threads );
+        }
       private:
         /**
          *  @brief  Add sequence of the paths in the set from `begin` to `end`.
@@ -279,7 +325,7 @@ namespace psi {
           inline bool
         load_paths_set( const std::string& filepath )
         {
-          std::ifstream ifs( filepath, std::ifstream::in | std::ifstream::binary );
+          MappedIStream ifs( filepath );
           if ( !ifs ) return false;
 
           try {
@@ -368,7 +368,7 @@ namespace psi {
       inline bool
     open( PathSet< TPath, TSpec >& set, const std::string& file_path )
     {
-      std::ifstream ifs( file_path, std::ifstream::in | std::ifstream::binary );
+      MappedIStream ifs( file_path );
       if( !ifs ) return false;
       set.load( ifs );
       return true;
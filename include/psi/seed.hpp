@@ -19,6 +19,9 @@
 #define PSI_SEED_HPP__
 
 #include <cstdlib>
+#include <vector>
+#include <utility>
+#include <type_traits>
 
 #include "base.hpp"
 
@@ -43,7 +46,108 @@ namespace psi {
     offset_type read_offset;                      /**< @brief Read offset. */
     offset_type match_len;                        /**< @brief Seed match length. */
     offset_type gocc;                             /**< @brief Genome occurrence count. */
+    offset_type mismatches = 0;                   /**< @brief Number of mismatches. */
   };  /* --- end of class Seed --- */
+
+  /**
+   *  @brief  Seed callback passing the seeds to a batch sink.
+   *
+   *  The seeds are buffered and passed to the sink as spans of contiguous seeds; i.e.
+   *  `sink( seeds, count )` where `seeds` points to the first of `count` seeds. The
+   *  buffered seeds are passed when the buffer is full or on `flush`. The functions
+   *  reporting seeds to a callback template flush it before they return (see
+   *  `flush_seeds`); it should not be wrapped in a `std::function` for this reason.
+   *
+   *  A copy has its own empty buffer but the same sink; e.g. one for each thread.
+   */
+  template< typename TSink, typename TSeed = Seed<> >
+    class SeedBatchSink {
+      public:
+        /* === TYPEDEFS === */
+        typedef TSeed value_type;
+        /* === CONSTANTS === */
+        constexpr static const std::size_t DEFAULT_CAPACITY = 1024;
+        /* === LIFECYCLE === */
+        SeedBatchSink( TSink s, std::size_t cap=DEFAULT_CAPACITY )
+          : sink( std::move( s ) ), capacity( cap != 0 ? cap : 1 )
+        {
+          this->buffer.reserve( this->capacity );
+        }
+
+        SeedBatchSink( SeedBatchSink const& other )
+          : SeedBatchSink( other.sink, other.capacity )
+        { }
+
+        SeedBatchSink( SeedBatchSink&& ) = default;
+        SeedBatchSink& operator=( SeedBatchSink const& ) = delete;
+        SeedBatchSink& operator=( SeedBatchSink&& ) = default;
+        ~SeedBatchSink( ) = default;
+        /* === OPERATORS === */
+          inline void
+        operator()( value_type const& hit )
+        {
+          this->buffer.push_back( hit );
+          if ( this->buffer.size() == this->capacity ) this->flush();
+        }
+        /* === METHODS === */
+          inline void
+        flush( )
+        {
+          if ( this->buffer.empty() ) return;
+          this->sink( static_cast< value_type const* >( this->buffer.data() ),
+                      this->buffer.size() );
+          this->buffer.clear();
+        }
+      private:
+        /* === DATA MEMBERS === */
+        TSink sink;
+        std::size_t capacity;
+        std::vector< value_type > buffer;
+    };  /* --- end of class SeedBatchSink --- */
+
+  template< typename TSeed = Seed<>, typename TSink >
+      inline SeedBatchSink< std::decay_t< TSink >, TSeed >
+    make_seed_batch_sink( TSink&& sink,
+        std::size_t capacity=SeedBatchSink< std::decay_t< TSink >, TSeed >::DEFAULT_CAPACITY )
+    {
+      return SeedBatchSink< std::decay_t< TSink >, TSeed >( std::forward< TSink >( sink ),
+                                                            capacity );
+    }
+
+  /**
+   *  @brief  Pass the buffered seeds of a seed callback, if any, to its sink.
+   */
+  template< typename TCallback >
+      inline void
+    flush_seeds( TCallback& )
+    { /* NOOP */ }
+
+  template< typename TSink, typename TSeed >
+      inline void
+    flush_seeds( SeedBatchSink< TSink, TSeed >& callback )
+    {
+      callback.flush();
+    }
+
+  /**
+   *  @brief  Get the seed callback to be used by another thread.
+   *
+   *  The callback itself is shared by the threads except for batch sinks whose
+   *  buffers cannot be shared; a copy with its own buffer is returned for them.
+   */
+  template< typename TCallback >
+      inline TCallback&
+    fork_seed_callback( TCallback& callback )
+    {
+      return callback;
+    }
+
+  template< typename TSink, typename TSeed >
+      inline SeedBatchSink< TSink, TSeed >
+    fork_seed_callback( SeedBatchSink< TSink, TSeed >& callback )
+    {
+      return callback;
+    }
 }  /* --- end of namespace psi --- */
 
 #endif  /* --- #ifndef PSI_SEED_HPP__ --- */
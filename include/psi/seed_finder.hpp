@@ -22,12 +22,20 @@
 #include <type_traits>
 #include <atomic>
 #include <vector>
+#include <deque>
 #include <unordered_set>
 #include <unordered_map>
 #include <iterator>
 #include <functional>
 #include <algorithm>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <exception>
 #include <stdexcept>
+#include <limits>
 
 #include <sdsl/bit_vectors.hpp>
 #include <diverg/dindex.hpp>
@@ -246,8 +254,9 @@ namespace psi {
       private:
         /* === DATA MEMBERS === */
         seedfinder_type const* finder_ptr;
-        progress_type progress;
+        std::atomic< progress_type > progress;  /**< @brief Index components may be loaded concurrently. */
         container_type tstats;
+        RWSpinLock<> tstats_lock;  /**< @brief Guards insertions into `tstats`. */
         std::string id;
 
         /* === STATIC MEMBERS === */
@@ -377,15 +386,24 @@ namespace psi {
           inline const char*
         get_progress_str( ) const
         {
-          return base_type::progress_table[ this->progress ];
+          return base_type::progress_table[ this->progress.load() ];
         }
 
         /**
          *  @brief  Get the statistics for the thread with the given `id`.
+         *
+         *  NOTE: It is safe to be called concurrently. The references to the
+         *  `ThreadStats` objects remain valid after insertion of new threads.
          */
           inline ThreadStats&
         get_thread_stats( std::string const& id )
         {
+          {
+            ReaderLock lock( this->tstats_lock );
+            auto found = this->tstats.find( id );
+            if ( found != this->tstats.end() ) return found->second;
+          }
+          WriterLock lock( this->tstats_lock );
           return this->tstats[ id ];
         }
 
@@ -446,13 +464,13 @@ namespace psi {
           inline timer_type::period_type
         get_timer( std::string const& name ) const
         {
-          return timer_type::get_timers()[ this->id + name ];
+          return timer_type::get_period( this->id + name );
         }
 
           inline timer_type::period_type
         get_timer( std::string const& name, std::string const& thread_id ) const
         {
-          return timer_type::get_timers()[ this->id + name + thread_id ];
+          return timer_type::get_period( this->id + name + thread_id );
         }
 
         template< typename TCallback >
@@ -730,7 +748,8 @@ namespace psi {
             typename TReadsIndexSpec = seqan2::IndexWotd<>,
             typename TPathsStringSetSpec = DiskBased,
             typename TStrategy = BFS,
-            template<typename, typename> class TMatchingTraits = ExactMatching >
+            template<typename, typename> class TMatchingTraits = ExactMatching,
+            typename TPathIndexSpec = FMIndex<> >
   struct SeedFinderTraits {
     typedef gum::SeqGraph< TGraphSpec > graph_type;
     typedef seqan2::Index< TReadsStringSet, TReadsIndexSpec > seedindex_type;
@@ -741,6 +760,7 @@ namespace psi {
                                                  TStatsSpec >::Type;
 
     typedef TPathsStringSetSpec pathstrsetspec_type;
+    typedef TPathIndexSpec pathindexspec_type;  /**< @brief FM index sampling profile. */
   };
 
   template< typename TStatsSpec = NoStats,
@@ -767,16 +787,21 @@ namespace psi {
         typedef typename traits_type::graph_type graph_type;
         typedef typename traits_type::template traverser_type< TStatsSpec > traverser_type;
         typedef typename traits_type::pathstrsetspec_type pathstrsetspec_type;
+        typedef typename traits_type::pathindexspec_type pathindexspec_type;
         typedef typename graph_type::id_type id_type;
         typedef typename graph_type::offset_type offset_type;
         typedef typename graph_type::rank_type rank_type;
+        typedef GraphSnapshot< graph_type > snapshot_type;
         typedef StatsType< SeedFinder > stats_type;
         typedef typename stats_type::progress_type progress_type;
         typedef typename stats_type::thread_progress_type thread_progress_type;
         typedef Records< typename traverser_type::stringset_type > readsrecord_type;
         typedef typename traverser_type::index_type readsindex_type;
+        typedef std::function< void( typename traverser_type::output_type const& ) > callback_type;
         typedef YaString< pathstrsetspec_type > text_type;
-        typedef PathIndex< graph_type, text_type, psi::FMIndex<>, Reversed > pathindex_type;
+        typedef PathIndex< graph_type, text_type, pathindexspec_type, Reversed > pathindex_type;
+        typedef PathIndex< graph_type, seqan2::Dna5String, CBiFMIndex, Forward > memindex_type;
+        typedef seqan2::Index< Dna5QStringSet<>, KmerIndex<> > lociindex_type;
         typedef uint32_t crsmat_ordinal_type;
         typedef uint64_t crsmat_size_type;
         // Range-sparse execution space following the Kokkos backend:
@@ -933,7 +958,7 @@ namespace psi {
             unsigned int mxmem = 0,
             unsigned char mismatches = 0,
             Kokkos::InitializationSettings kokkos_settings = {} )
-          : graph_ptr( &g ), pindex( g, true ),
+          : graph_ptr( &g ), pindex( g, true ), mindex( g, true ),
           handler( get_kokkos_handling_status(), kokkos_settings ),
           seed_len( len ), seed_mismatches( mismatches ),
           gocc_threshold( ( gocc_thr != 0 ? gocc_thr : UINT_MAX ) ),
@@ -1004,6 +1029,15 @@ namespace psi {
           return this->pindex;
         }
 
+        /**
+         *  @brief  getter function for snapshot.
+         */
+          inline snapshot_type const&
+        get_graph_snapshot( ) const
+        {
+          return this->snapshot;
+        }
+
         /**
          *  @brief  getter function for distance index matrix.
          */
@@ -1030,24 +1064,31 @@ namespace psi {
         set_graph_ptr( const graph_type* value )
         {
           this->graph_ptr = value;
+          this->snapshot.clear();
         }
 
         /**
          *  @brief  setter function for starting_loci.
+         *
+         *  NOTE: The starting loci index is cleared (see `create_loci_index`).
          */
           inline void
         set_starting_loci( std::vector< Position<> > loci )
         {
           this->starting_loci = std::move( loci );
+          this->lindex.clear();
         }
 
         /**
          *  @brief  setter function for seed_len.
+         *
+         *  NOTE: The starting loci index is cleared (see `create_loci_index`).
          */
           inline void
         set_seed_len( unsigned int value )
         {
           this->seed_len = value;
+          this->lindex.clear();
         }
 
         /**
@@ -1086,6 +1127,12 @@ namespace psi {
           return readsrecord_type();
         }
 
+        /**
+         *  @brief  Index a chunk of seeds.
+         *
+         *  NOTE: FM indexes are built on the reversed seeds (see `make_reads_index`);
+         *  the seeds should have the same length as the seed length.
+         */
           inline readsindex_type
         index_reads( readsrecord_type const& reads ) const
         {
@@ -1093,7 +1140,7 @@ namespace psi {
               thread_progress_type::index_chunk );
           [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "index-reads" );
 
-          return readsindex_type( reads.str );
+          return make_reads_index< readsindex_type >( reads.str );
         }
 
         template< typename T >
@@ -1112,6 +1159,7 @@ namespace psi {
         add_start( const Position<>& locus )
         {
           this->starting_loci.push_back( locus );
+          this->lindex.clear();
         }
 
           inline void
@@ -1166,13 +1214,150 @@ namespace psi {
                 } );
           }
 
+        /**
+         *  @brief  Index the selected paths.
+         *
+         *  @param  qgram_len The length of q-grams in the path index lookup table;
+         *                    no table is built if it is zero.
+         *  @param  nof_threads The number of threads.
+         *
+         *  The path sequences are extracted and the q-gram table is built in parallel;
+         *  the suffix array construction itself is single-threaded.
+         */
         inline void
-        index_paths( )
+        index_paths( unsigned int qgram_len=0, unsigned int nof_threads=1 )
         {
           this->stats_ptr->set_progress( progress_type::create_pindex );
           [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "index-paths" );
 
-          this->pindex.create_index();
+          this->pindex.create_index( nof_threads );
+          if ( qgram_len != 0 ) this->pindex.create_qgram_table( qgram_len, nof_threads );
+        }
+
+        /**
+         *  @brief  Take a traversal-optimised snapshot of the graph.
+         *
+         *  The traversers created afterwards (see `create_traverser`) step through the
+         *  snapshot by node rank instead of the graph. It should be called once the graph
+         *  is loaded; it is cleared if the graph is replaced.
+         */
+        inline void
+        create_graph_snapshot( )
+        {
+          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "graph-snapshot" );
+          this->snapshot.build( *this->graph_ptr );
+        }
+
+        /**
+         *  @brief  Index the forward sequences of the selected paths bidirectionally.
+         *
+         *  The bidirectional index allows `seeds_on_paths` to find all super-maximal
+         *  exact matches of a sequence in one pass. It is not serialised with the path
+         *  index; so it should be created after creating or loading the path index.
+         */
+        inline void
+        create_mem_index( )
+        {
+          this->mindex.clear();
+          this->mindex.set_context( this->pindex.get_context() );
+          for ( auto const& path : this->pindex.get_paths_set() ) this->mindex.add_path( path );
+          this->mindex.create_index();
+        }
+
+        /**
+         *  @brief  Index the distinct k-mers spelled from the starting loci.
+         *
+         *  @param  nof_threads The number of threads.
+         *
+         *  The k-mers of the graph walks of seed length starting from each starting locus
+         *  are sorted with the lists of their loci; i.e. a trie of depth `seed_len`.
+         *  When it is created, `seeds_off_paths` matches it against the reads index in
+         *  one joint descent instead of traversing from each locus independently; so the
+         *  shared prefixes of the k-mers and the duplicate k-mers are searched once. It
+         *  is not persisted; and it is cleared whenever the starting loci or the seed
+         *  length change, so it should be recreated after them (e.g. after loading).
+         *
+         *  The walks are enumerated by the threads on node-aligned ranges of the loci.
+         *  The k-mers of a locus are deduplicated as soon as its walks are enumerated,
+         *  and each thread sorts its own pairs; so the index holds one entry per distinct
+         *  (k-mer, locus) pair. Their number is the number of loci times the average
+         *  number of distinct walks from a locus, which grows with the variant density.
+         *
+         *  NOTE: It requires exact matching and seed length of at most
+         *  `lociindex_type::MAX_K`.
+         */
+        inline void
+        create_loci_index( unsigned int nof_threads=1 )
+        {
+          typedef std::pair< typename lociindex_type::kmer_type, std::size_t > pair_type;
+
+          if ( traverser_type::max_mismatches != 0 ) {
+            throw std::runtime_error( "starting loci index only supports exact matching" );
+          }
+          if ( this->seed_len > lociindex_type::MAX_K ) {
+            throw std::runtime_error( "starting loci index only supports seed lengths up to " +
+                                      std::to_string( lociindex_type::MAX_K ) );
+          }
+
+          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "index-loci" );
+
+          if ( nof_threads == 0 ) nof_threads = 1;
+          auto ranges = this->loci_ranges( nof_threads );
+          std::vector< std::vector< pair_type > > parts( ranges.size() );
+          std::exception_ptr eptr = nullptr;
+          std::mutex eptr_lock;
+          auto worker = [&]( std::size_t ridx ) {
+            try {
+              auto& part = parts[ ridx ];
+              for ( std::size_t idx = ranges[ ridx ].first; idx < ranges[ ridx ].second; ++idx ) {
+                const auto& locus = this->starting_loci[ idx ];
+                auto first = part.size();
+                this->add_kmers_at( locus.node_id(), locus.offset(), 0, 0, idx, part );
+                /* Walks from a locus merging back (e.g. bubbles) spell the same k-mer. */
+                std::sort( part.begin() + first, part.end() );
+                part.erase( std::unique( part.begin() + first, part.end() ), part.end() );
+              }
+              std::sort( part.begin(), part.end() );
+            }
+            catch ( ... ) {
+              std::lock_guard< std::mutex > lock( eptr_lock );
+              if ( !eptr ) eptr = std::current_exception();
+            }
+          };
+
+          std::vector< std::thread > workers;
+          workers.reserve( ranges.size() );
+          for ( std::size_t i = 0; i < ranges.size(); ++i ) workers.emplace_back( worker, i );
+          for ( auto& w : workers ) w.join();
+          if ( eptr ) std::rethrow_exception( eptr );
+
+          /* Concatenate the sorted parts and merge the adjacent ones in rounds. */
+          std::vector< pair_type > pairs;
+          std::size_t total = 0;
+          for ( auto const& part : parts ) total += part.size();
+          pairs.reserve( total );
+          std::vector< std::size_t > bounds( 1, 0 );
+          for ( auto& part : parts ) {
+            pairs.insert( pairs.end(), part.begin(), part.end() );
+            std::vector< pair_type >().swap( part );
+            bounds.push_back( pairs.size() );
+          }
+          while ( bounds.size() > 2 ) {
+            std::vector< std::size_t > merged( 1, 0 );
+            workers.clear();
+            for ( std::size_t i = 0; i + 2 < bounds.size(); i += 2 ) {
+              workers.emplace_back(
+                  [&pairs, first=bounds[ i ], middle=bounds[ i + 1 ], last=bounds[ i + 2 ]]( ) {
+                    std::inplace_merge( pairs.begin() + first, pairs.begin() + middle,
+                                        pairs.begin() + last );
+                  } );
+              merged.push_back( bounds[ i + 2 ] );
+            }
+            if ( bounds.size() % 2 == 0 ) merged.push_back( bounds.back() );
+            for ( auto& w : workers ) w.join();
+            bounds.swap( merged );
+          }
+          this->lindex.build( this->seed_len, pairs );
         }
 
       /**
@@ -1184,6 +1369,14 @@ namespace psi {
        *  by the largest component, at the cost of building the index component
        *  by component.
        *
+       *  The blocks can be built by `nof_threads` threads concurrently while they are
+       *  still stitched in order. A block is only started if the estimated memory of
+       *  all blocks in flight (built but not stitched yet) stays within `mem_limit`
+       *  bytes; the first block in the queue is always started when nothing else is in
+       *  flight. The limit defaults to half of the available physical memory; or no
+       *  limit if it cannot be determined. The memory of a block is estimated by the
+       *  number of its entries (see `estimate_dindex_nnz`).
+       *
        *  NOTE: This method assumes that the input graph is sorted such that node rank
        *  ranges in components are disjoint.
        *
@@ -1193,7 +1386,8 @@ namespace psi {
         inline void
         create_distance_index( unsigned int dmin, unsigned int dmax, PerComponent,
                                std::function< void( std::string const& ) > info=nullptr,
-                               std::function< void( std::string const& ) > warn=nullptr )
+                               std::function< void( std::string const& ) > warn=nullptr,
+                               unsigned int nof_threads=1, std::size_t mem_limit=0 )
         {
           if ( dmin == 0 || dmax < dmin ) return;  // not constructible
           if ( dmax == 0 ) dmax = dmin;
@@ -1204,30 +1398,78 @@ namespace psi {
           /* Extract component boundary node ranks. */
           auto comp_ranks = util::components_ranks( *this->graph_ptr );
           comp_ranks.push_back( 0 );  // add the upper bound of the last component
+          std::size_t nof_comps = comp_ranks.size() - 1;
 
           if ( info ) {
             info( "Constructing distance index for " +
-                  std::to_string( comp_ranks.size()-1 ) + " regions..." );
+                  std::to_string( nof_comps ) + " regions..." );
           }
 
-          auto provider = [this, dmin, dmax, &comp_ranks, info]( auto partial ) {
-            for ( std::size_t idx = 0; idx < comp_ranks.size()-1; ++idx ) {
-              auto ra = diverg::util::range_adjacency_matrix< mut_crsmat_type >(
-                  *this->graph_ptr, comp_ranks[ idx ], comp_ranks[ idx + 1 ] );
-              auto rc = diverg::util::create_distance_index( ra, dmin, dmax,
-                                                             rsparse_config_type{} );
-              auto sid = this->graph_ptr->rank_to_id( comp_ranks[ idx ] );
-              auto soff = static_cast< crsmat_ordinal_type >(
-                  gum::util::id_to_charorder( *this->graph_ptr, sid ) );
-              partial( rc, soff, soff );
-              if ( info ) {
-                info( "Created distance index for region " + std::to_string( idx+1 ) + "." );
-              }
+          auto comp_offset = [this, &comp_ranks]( std::size_t idx ) -> std::size_t {
+            if ( comp_ranks[ idx ] == 0 ) return gum::util::total_nof_loci( *this->graph_ptr );
+            auto sid = this->graph_ptr->rank_to_id( comp_ranks[ idx ] );
+            return gum::util::id_to_charorder( *this->graph_ptr, sid );
+          };
+          auto build = [this, dmin, dmax, &comp_ranks]( std::size_t idx ) {
+            auto ra = diverg::util::range_adjacency_matrix< mut_crsmat_type >(
+                *this->graph_ptr, comp_ranks[ idx ], comp_ranks[ idx + 1 ] );
+            return diverg::util::create_distance_index( ra, dmin, dmax,
+                                                        rsparse_config_type{} );
+          };
+          auto stitched = [info]( std::size_t idx ) {
+            if ( info ) {
+              info( "Created distance index for region " + std::to_string( idx+1 ) + "." );
             }
           };
+
           auto nrows = gum::util::total_nof_loci( *this->graph_ptr );
-          auto nnz_est = ( nrows - this->graph_ptr->get_node_count() +
-                           this->graph_ptr->get_edge_count() ) * 4;
+          auto nnz_est = SeedFinder::estimate_dindex_nnz( nrows,
+                                                          this->graph_ptr->get_node_count(),
+                                                          this->graph_ptr->get_edge_count(),
+                                                          nof_comps, dmax );
+
+          std::vector< std::size_t > mem_est;
+          std::function< void( std::function< void( std::size_t, decltype( build( 0 ) )& ) > ) >
+              for_each_block;
+          if ( nof_threads <= 1 || nof_comps <= 1 ) {
+            for_each_block = [&build, nof_comps]( auto callback ) {
+              for ( std::size_t idx = 0; idx < nof_comps; ++idx ) {
+                auto rc = build( idx );
+                callback( idx, rc );
+              }
+            };
+          }
+          else {
+            if ( mem_limit == 0 ) mem_limit = get_available_memory() / 2;
+            if ( mem_limit == 0 ) {
+              if ( warn ) warn( "Cannot determine the available memory; building the "
+                                "distance index blocks with no memory limit..." );
+              mem_limit = std::numeric_limits< std::size_t >::max();
+            }
+            /* Rough estimation of the memory footprint of a component's block: its share
+             * of the estimated entries by its loci (twice for the range adjacency matrix
+             * and the intermediate matrices) plus the row map. */
+            double nnz_per_locus = nrows == 0 ? 0 : static_cast< double >( nnz_est ) / nrows;
+            mem_est.resize( nof_comps );
+            for ( std::size_t idx = 0; idx < nof_comps; ++idx ) {
+              std::size_t nof_loci = comp_offset( idx + 1 ) - comp_offset( idx );
+              auto nnz = static_cast< std::size_t >( nof_loci * nnz_per_locus );
+              mem_est[ idx ] = nnz * 2 * sizeof( crsmat_ordinal_type )
+                  + nof_loci * sizeof( crsmat_size_type );
+            }
+            for_each_block = [&build, &mem_est, nof_comps, nof_threads, mem_limit]( auto callback ) {
+              SeedFinder::build_blocks_parallel( build, callback, mem_est, nof_comps,
+                                                 nof_threads, mem_limit );
+            };
+          }
+
+          auto provider = [&for_each_block, &comp_offset, &stitched]( auto partial ) {
+            for_each_block( [&]( std::size_t idx, auto& rc ) {
+                auto soff = static_cast< crsmat_ordinal_type >( comp_offset( idx ) );
+                partial( rc, soff, soff );
+                stitched( idx );
+              } );
+          };
           mut_crsmat_type udindex( nrows, nrows, provider, nnz_est );
           this->distance_mat.assign( udindex );
 
@@ -1246,7 +1488,8 @@ namespace psi {
         inline void
         create_distance_index( unsigned int dmin, unsigned int dmax, Whole,
                                std::function< void( std::string const& ) > info=nullptr,
-                               std::function< void( std::string const& ) > warn=nullptr )
+                               std::function< void( std::string const& ) > warn=nullptr,
+                               unsigned int=1, std::size_t=0 )
         {
           if ( dmin == 0 || dmax < dmin ) return;  // not constructible
           if ( dmax == 0 ) dmax = dmin;
@@ -1287,11 +1530,11 @@ namespace psi {
           this->d = std::make_pair( dmin, dmax );
 
           auto fname = SeedFinder::get_distance_index_path( prefix, this->d.first, this->d.second );
-          std::ifstream ifs( fname, std::ifstream::in | std::ifstream::binary );
+          MappedIStream ifs( fname );
           if ( !ifs ) return false;
 
           this->stats_ptr->set_progress( progress_type::load_dindex );
-          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "load-dindex" );
+          [[maybe_unused]] auto timer = this->stats_ptr->timeit( "load-dindex" );
 
           this->distance_mat.load( ifs );
           return true;
@@ -1316,6 +1559,81 @@ namespace psi {
           return this->distance_mat( v_charid, u_charid );
         }
 
+        /**
+         *  @brief  Verify distance constraints for a batch of position pairs.
+         *
+         *  @param[in]  queries Random-access container of pairs of positions, each as a
+         *                      tuple-like `(v, o, u, p)` (see `verify_distance`).
+         *  @param[out]  result The i-th bit is set iff the i-th pair satisfies the
+         *                      distance constraints.
+         *
+         *  The first node ids are translated to character order once per node and the
+         *  inter-node queries are answered in the order of their rows in the distance
+         *  matrix; so queries on the same row hit the same (cached) CRS row. Unlike
+         *  calling `verify_distance` for each pair, the stats and timer are updated once
+         *  per batch.
+         */
+        template< typename TQueries >
+          inline void
+        verify_distances( TQueries const& queries, sdsl::bit_vector& result ) const
+        {
+          struct CharQuery {
+            crsmat_ordinal_type row;
+            crsmat_ordinal_type col;
+            std::size_t idx;
+          };
+
+          sdsl::util::assign( result, sdsl::bit_vector( queries.size(), 0 ) );
+          if ( queries.size() == 0 ) return;
+
+          this->stats_ptr->set_progress( progress_type::ready );
+          this->stats_ptr->get_this_thread_stats().set_progress(
+              thread_progress_type::query_dindex );
+
+          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "query-dindex" );
+
+          std::vector< std::size_t > inter;  // indices of inter-node queries
+          inter.reserve( queries.size() );
+          for ( std::size_t i = 0; i < queries.size(); ++i ) {
+            auto const& q = queries[ i ];
+            if ( std::get< 0 >( q ) != std::get< 2 >( q ) ) inter.push_back( i );
+            else {  // intra-node distance
+              auto o = std::get< 1 >( q );
+              auto p = std::get< 3 >( q );
+              result[ i ] = ( o <= p && this->d.first <= ( p - o ) && ( p - o ) <= this->d.second );
+            }
+          }
+
+          /* Group queries by their first node so that its id is translated once. */
+          auto by_node = [&queries]( std::size_t i, std::size_t j ) {
+            return std::get< 0 >( queries[ i ] ) < std::get< 0 >( queries[ j ] );
+          };
+          std::sort( inter.begin(), inter.end(), by_node );
+
+          std::vector< CharQuery > charqs;
+          charqs.reserve( inter.size() );
+          id_type pre_v = 0;
+          crsmat_ordinal_type v_charorder = 0;
+          for ( auto i : inter ) {
+            auto const& q = queries[ i ];
+            if ( std::get< 0 >( q ) != pre_v ) {
+              pre_v = std::get< 0 >( q );
+              v_charorder = gum::util::id_to_charorder( *this->graph_ptr, pre_v );
+            }
+            crsmat_ordinal_type u_charorder =
+                gum::util::id_to_charorder( *this->graph_ptr, std::get< 2 >( q ) );
+            charqs.push_back( { static_cast< crsmat_ordinal_type >( v_charorder + std::get< 1 >( q ) ),
+                                static_cast< crsmat_ordinal_type >( u_charorder + std::get< 3 >( q ) ),
+                                i } );
+          }
+
+          std::sort( charqs.begin(), charqs.end(),
+                     []( CharQuery const& a, CharQuery const& b ) {
+                       return a.row < b.row || ( a.row == b.row && a.col < b.col );
+                     } );
+          for ( auto const& q : charqs ) result[ q.idx ] = this->distance_mat( q.row, q.col );
+        }
+
         /**
          *  @brief  Create path index.
          *
@@ -1326,6 +1644,8 @@ namespace psi {
          *  @param  dmin  The distance index minimum read insert size.
          *  @param  dmax  The distance index maximum read insert size.
          *  @param  progress A callback function reporting the progress of path selection.
+         *  @param  nof_threads The number of threads constructing the path and distance indices.
+         *  @param  qgram_len The length of q-grams in the path index lookup table.
          */
         template< typename TDIndexMode = PerComponent >
         inline void
@@ -1334,7 +1654,8 @@ namespace psi {
             unsigned int dmin=0, unsigned int dmax=0,
             TDIndexMode mode={},
             std::function< void( std::string const& ) > info=nullptr,
-            std::function< void( std::string const& ) > warn=nullptr )
+            std::function< void( std::string const& ) > warn=nullptr,
+            unsigned int nof_threads=1, unsigned int qgram_len=0 )
         {
           /* Select the requested number of genome-wide paths. */
           std::function< void( std::string const&, int ) > progress = nullptr;
@@ -1347,11 +1668,11 @@ namespace psi {
           }
           this->pick_paths( n, patched, context, progress, info, warn );
           if ( info ) info( "Indexing the selected paths..." );
-          this->index_paths();
+          this->index_paths( qgram_len, nof_threads );
           if ( info ) info( "Detecting uncovered loci..." );
           this->add_uncovered_loci( step_size );
           if ( info ) info( "Constructing distance index for pair distance queries..." );
-          this->create_distance_index( dmin, dmax, mode, info, warn );
+          this->create_distance_index( dmin, dmax, mode, info, warn, nof_threads );
         }
 
         inline bool
@@ -1382,27 +1703,91 @@ namespace psi {
          *
          */
         inline bool
-        load_path_index_only( std::string const& fpath, unsigned int context=0 )
+        load_path_index_only( std::string const& fpath, unsigned int context=0,
+                              std::function< void() > wait_graph=nullptr )
         {
           if ( fpath.empty() ) return false;
 
           this->stats_ptr->set_progress( progress_type::load_pindex );
-          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "load-pindex" );
-
+          this->pindex.clear();
           this->pindex.set_context( context );
-          return this->pindex.load( fpath );
+          {
+            [[maybe_unused]] auto timer = this->stats_ptr->timeit( "load-pindex" );
+            if ( !this->pindex.load_index( fpath ) ) return false;
+          }
+          if ( wait_graph ) wait_graph();
+          {
+            [[maybe_unused]] auto timer = this->stats_ptr->timeit( "load-paths" );
+            if ( this->pindex.load_paths( fpath ) ) return true;
+          }
+          this->pindex.clear();
+          return false;
         }
 
+        /**
+         *  @brief  Load path index, starting loci and distance index concurrently.
+         *
+         *  @param  load_graph The callback loading the graph [optional].
+         *
+         *  The components are stored in separate files and are loaded by different
+         *  threads. The index of the paths and the distance index do not depend on the
+         *  graph, and are loaded while the graph is being loaded by `load_graph` in the
+         *  calling thread. The paths set and the starting loci require the graph for node
+         *  id translation; so their translation waits for `load_graph` to return. The
+         *  graph is assumed to be loaded if `load_graph` is not specified.
+         *
+         *  Missing starting loci or distance index are constructed (and saved) after all
+         *  components are loaded.
+         */
         inline bool
         load_path_index( std::string const& fpath, unsigned int context=0,
-                         unsigned int step_size=1, unsigned int dmin=0, unsigned int dmax=0 )
+                         unsigned int step_size=1, unsigned int dmin=0, unsigned int dmax=0,
+                         std::function< void() > load_graph=nullptr )
         {
-          if ( !this->load_path_index_only( fpath, context ) ) return false;
-          if ( !this->open_starts( fpath, this->seed_len, step_size ) ) {
+          if ( fpath.empty() ) {
+            if ( load_graph ) load_graph();
+            return false;
+          }
+
+          std::promise< void > graph_promise;
+          std::shared_future< void > graph_loaded = graph_promise.get_future().share();
+          auto wait_graph = [graph_loaded]() { graph_loaded.get(); };
+
+          auto pindex_loaded = std::async( std::launch::async, [&]() {
+              return this->load_path_index_only( fpath, context, wait_graph );
+            } );
+          auto starts_loaded = std::async( std::launch::async, [&]() {
+              return this->open_starts( fpath, this->seed_len, step_size, wait_graph );
+            } );
+          auto dindex_loaded = std::async( std::launch::async, [&]() {
+              return this->open_distance_index( fpath, dmin, dmax );
+            } );
+
+          try {
+            if ( load_graph ) load_graph();
+            graph_promise.set_value();
+          }
+          catch ( ... ) {
+            graph_promise.set_exception( std::current_exception() );
+          }
+
+          /* The futures join their threads on destruction if anyone throws. */
+          bool has_pindex = pindex_loaded.get();
+          bool has_starts = starts_loaded.get();
+          bool has_dindex = dindex_loaded.get();
+          graph_loaded.get();
+
+          if ( !has_pindex ) {
+            /* Starting loci depend on the paths; the distance index does not. */
+            this->starting_loci.clear();
+            this->lindex.clear();
+            return false;
+          }
+          if ( !has_starts ) {
             this->add_uncovered_loci( step_size );
             this->save_starts( fpath, this->seed_len, step_size );
           }
-          if ( !this->open_distance_index( fpath, dmin, dmax ) ) {
+          if ( !has_dindex ) {
             // TODO: The fallback strategy for constructing distance index is
             // always `PerComponent` for now since `dindex-mode` is not
             // propagated into here.
@@ -1425,7 +1810,22 @@ namespace psi {
          */
             inline void
           seeds_on_paths( readsrecord_type const& reads, readsindex_type& reads_index,
-                          std::function< void(typename traverser_type::output_type const &) > callback ) const
+                          callback_type callback ) const
+          {
+            this->template seeds_on_paths< callback_type& >( reads, reads_index, callback );
+          }
+
+          /**
+           *  @brief  Find seeds on paths by any callable.
+           *
+           *  The callback is called directly (not through `std::function`) per seed; it
+           *  can be a seed batch sink (see `make_seed_batch_sink`) which is flushed at the
+           *  end.
+           */
+          template< typename TCallback >
+            inline void
+          seeds_on_paths( readsrecord_type const& reads, readsindex_type& reads_index,
+                          TCallback&& callback ) const
           {
             typedef TopDownFine< seqan2::ParentLinks<> > TIterSpec;
             typedef typename seqan2::Iterator< typename pathindex_type::index_type, TIterSpec >::Type TPIterator;
@@ -1453,13 +1853,95 @@ namespace psi {
                 };
 
             kmer_exact_matches( piter, riter, &this->pindex, &reads, this->seed_len,
-                                callback, this->gocc_threshold, collect_stats );
+                                std::ref( callback ), this->gocc_threshold, collect_stats );
+            flush_seeds( callback );
+          }
+
+          /**
+           *  @brief  Find seeds on paths using multiple threads.
+           *
+           *  The k-mer space is partitioned by k-mer prefixes which are enumerated by
+           *  the worker threads concurrently (see `kmer_exact_matches`).
+           *
+           *  NOTE: The callback is called concurrently from worker threads; it should be
+           *  thread-safe.
+           *
+           *  NOTE: The reads index is fully constructed beforehand (if it is lazy), so
+           *  that it can be traversed concurrently.
+           */
+          inline void
+          seeds_on_paths( readsrecord_type const& reads, readsindex_type& reads_index,
+                          callback_type callback, unsigned int nof_threads ) const
+          {
+            this->template seeds_on_paths< callback_type& >( reads, reads_index, callback, nof_threads );
+          }
+
+          template< typename TCallback >
+          inline void
+          seeds_on_paths( readsrecord_type const& reads, readsindex_type& reads_index,
+                          TCallback&& callback, unsigned int nof_threads ) const
+          {
+            typedef std::decay_t< decltype( this->stats_ptr->get_this_thread_stats() ) > thread_stats_type;
+            typedef std::function< void( std::size_t, bool ) > collector_type;
+
+            if ( nof_threads <= 1 ) {
+              this->seeds_on_paths( reads, reads_index, callback );
+              return;
+            }
+
+            auto context = this->pindex.get_context();
+            if (  context != 0 /* means patched */ && context < this->seed_len ) {
+              throw std::runtime_error( "seed length should not be larger than context size" );
+            }
+
+            if ( length( this->pindex.index ) == 0 ) return;
+            create_index( reads_index );
+
+            this->stats_ptr->set_progress( progress_type::ready );
+            [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "seeds-on-paths" );
+
+            /* Each worker calls its own copy; batch sinks get their own buffers. */
+            std::vector< std::decay_t< TCallback > > callbacks( nof_threads, callback );
+            std::vector< collector_type > collectors;
+            collectors.reserve( nof_threads );
+            for ( unsigned int i = 0; i < nof_threads; ++i ) {
+              /* Each collector is only called by one worker: bind it to its thread stats. */
+              collectors.push_back(
+                  [this, tstats=static_cast< thread_stats_type* >( nullptr )]
+                  ( std::size_t count, bool skipped ) mutable {
+                    if ( tstats == nullptr ) {
+                      tstats = &this->stats_ptr->get_this_thread_stats();
+                      tstats->set_progress( thread_progress_type::find_on_paths );
+                    }
+                    tstats->add_seed_gocc( count );
+                    if ( skipped ) tstats->inc_gocc_skips();
+                  } );
+            }
+
+            kmer_exact_matches( this->pindex.index, reads_index, &this->pindex, &reads,
+                                this->seed_len, callbacks, this->gocc_threshold,
+                                collectors );
+            for ( auto& cb : callbacks ) flush_seeds( cb );
           }
 
+          /**
+           *  @brief  Find maximal exact matches of a sequence on the paths.
+           *
+           *  If the bidirectional index of the paths is created (see
+           *  `create_mem_index`), all super-maximal exact matches are reported;
+           *  otherwise, the matches are found greedily using the path index which
+           *  misses the overlapping ones.
+           */
           template< typename TString >
           inline void
-          seeds_on_paths( TString const& sequence,
-                          std::function< void(typename traverser_type::output_type const &) > callback ) const
+          seeds_on_paths( TString const& sequence, callback_type callback ) const
+          {
+            this->template seeds_on_paths< TString, callback_type& >( sequence, callback );
+          }
+
+          template< typename TString, typename TCallback >
+          inline void
+          seeds_on_paths( TString const& sequence, TCallback&& callback ) const
           {
             typedef TopDownFine<> TIterSpec;
             typedef typename seqan2::Iterator< typename pathindex_type::index_type, TIterSpec >::Type TPIterator;
@@ -1472,10 +1954,18 @@ namespace psi {
 
             [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "query-paths" );
 
+            if ( this->mindex.size() != 0 ) {
+              find_mems( sequence, this->mindex.index, &this->mindex, this->seed_len,
+                         std::ref( callback ), this->gocc_threshold, this->max_mem );
+              flush_seeds( callback );
+              return;
+            }
+
             TPIterator piter( this->pindex.index );
             auto context = this->pindex.get_context();
-            find_mems( sequence, piter, &this->pindex, this->seed_len, context, callback,
+            find_mems( sequence, piter, &this->pindex, this->seed_len, context, std::ref( callback ),
                        this->gocc_threshold, this->max_mem );
+            flush_seeds( callback );
           }
 
             inline void
@@ -1636,16 +2126,21 @@ namespace psi {
 
           inline bool
         open_starts( const std::string& prefix, unsigned int seed_len,
-            unsigned int step_size )
+            unsigned int step_size, std::function< void() > wait_graph=nullptr )
         {
           std::string filepath = SeedFinder::get_sloci_filepath( prefix, seed_len, step_size );
-          std::ifstream ifs( filepath, std::ifstream::in | std::ifstream::binary );
+          MappedIStream ifs( filepath );
           if ( !ifs ) return false;
 
           this->stats_ptr->set_progress( progress_type::load_starts );
-          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "load-starts" );
+          {
+            [[maybe_unused]] auto timer = this->stats_ptr->timeit( "load-starts" );
+            SeedFinder::deserialize_starts( ifs, this->starting_loci );
+          }
+          this->lindex.clear();
 
-          SeedFinder::deserialize_starts( ifs, this->starting_loci );
+          /* Node ids are stored in the external coordinate system of the graph. */
+          if ( wait_graph ) wait_graph();
 
           auto callback = [this]( Position<> pos ) -> Position<> {
             pos.set_node_id( this->graph_ptr->id_by_coordinate( pos.node_id() ) );
@@ -1689,7 +2184,9 @@ namespace psi {
           inline traverser_type
         create_traverser( ) const
         {
-          return traverser_type( this->graph_ptr, this->seed_len );
+          traverser_type traverser( this->graph_ptr, this->seed_len );
+          if ( !this->snapshot.empty() ) traverser.set_snapshot_ptr( &this->snapshot );
+          return traverser;
         }
 
           inline void
@@ -1701,29 +2198,173 @@ namespace psi {
         }
 
           inline void
-        seeds_off_paths( traverser_type& traverser,
-                         std::function< void( typename traverser_type::output_type const& ) > callback ) const
+        seeds_off_paths( traverser_type& traverser, callback_type callback ) const
+        {
+          this->template seeds_off_paths< callback_type& >( traverser, callback );
+        }
+
+        /**
+         *  @brief  Find seeds off paths by any callable.
+         *
+         *  The callback is called directly (not through `std::function`) per seed; it
+         *  can be a seed batch sink (see `make_seed_batch_sink`) which is flushed at the
+         *  end.
+         */
+        template< typename TCallback >
+          inline void
+        seeds_off_paths( traverser_type& traverser, TCallback&& callback ) const
         {
           this->stats_ptr->set_progress( progress_type::ready );
           this->stats_ptr->get_this_thread_stats().set_progress(
               thread_progress_type::find_off_paths );
 
-          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "seeds-off-path" );
+          if ( !this->lindex.empty() ) {
+            // NOTE: SeqAn iterators require a non-const index; it is only read.
+            this->seeds_off_loci_index(
+                *traverser.get_reads(),
+                *const_cast< readsindex_type* >( traverser.get_reads_index() ),
+                callback );
+            flush_seeds( callback );
+            return;
+          }
 
-          for ( std::size_t idx = 0; idx < this->starting_loci.size(); ++idx )
-          {
-            const auto& locus = this->starting_loci[ idx ];
-            traverser.add_locus( locus );
-            if ( this->starting_loci[ idx + 1 ].node_id() == locus.node_id() ) continue;
+          [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "seeds-off-paths" );
 
-            traverser.run( callback );
-            this->stats_ptr->get_this_thread_stats().set_locus_idx( idx );
+          this->traverse_loci( traverser, 0, this->starting_loci.size(), callback );
+          flush_seeds( callback );
+        }
+
+        /**
+         *  @brief  Find seeds off paths using multiple threads.
+         *
+         *  @param[in]  reads The set of input reads.
+         *  @param[in]  reads_index The reads index.
+         *  @param[in]  callback The call back function applied on the found seeds.
+         *  @param[in]  nof_threads The number of threads.
+         *
+         *  The starting loci are split into node-aligned ranges which are initially
+         *  distributed evenly among threads. Each thread traverses its ranges by its own
+         *  traverser bound to the same reads index; a thread running out of ranges
+         *  steals from the back of the others' queues, since the traversal cost of the
+         *  loci varies considerably with the graph complexity around them.
+         *
+         *  NOTE: The callback is called concurrently from worker threads; it should be
+         *  thread-safe.
+         *
+         *  NOTE: The reads index is fully constructed beforehand (if it is lazy), so
+         *  that it can be traversed concurrently.
+         */
+          inline void
+        seeds_off_paths( readsrecord_type const& reads, readsindex_type& reads_index,
+                         callback_type callback, unsigned int nof_threads ) const
+        {
+          this->template seeds_off_paths< callback_type& >( reads, reads_index, callback, nof_threads );
+        }
+
+        template< typename TCallback >
+          inline void
+        seeds_off_paths( readsrecord_type const& reads, readsindex_type& reads_index,
+                         TCallback&& callback, unsigned int nof_threads ) const
+        {
+          typedef std::pair< std::size_t, std::size_t > range_type;
+
+          struct RangeQueue {
+            std::mutex lock;
+            std::deque< range_type > ranges;
+          };
+
+          if ( !this->lindex.empty() ) {
+            this->stats_ptr->set_progress( progress_type::ready );
+            this->seeds_off_loci_index( reads, reads_index, callback, nof_threads );
+            flush_seeds( callback );
+            return;
+          }
+
+          if ( nof_threads <= 1 ) {
+            auto traverser = this->create_traverser();
+            this->setup_traverser( traverser, reads, reads_index );
+            this->seeds_off_paths( traverser, callback );
+            return;
           }
+
+          if ( this->starting_loci.empty() ) return;
+          create_index( reads_index );
+
+          this->stats_ptr->set_progress( progress_type::ready );
+
+          auto ranges = this->loci_ranges( nof_threads * SeedFinder::RANGES_PER_THREAD );
+          std::vector< RangeQueue > queues( nof_threads );
+          for ( std::size_t i = 0; i < ranges.size(); ++i ) {
+            queues[ i * nof_threads / ranges.size() ].ranges.push_back( ranges[ i ] );
+          }
+
+          auto next_range = [&queues, nof_threads]( unsigned int tidx, range_type& range ) {
+            {
+              std::lock_guard< std::mutex > lock( queues[ tidx ].lock );
+              if ( !queues[ tidx ].ranges.empty() ) {
+                range = queues[ tidx ].ranges.front();
+                queues[ tidx ].ranges.pop_front();
+                return true;
+              }
+            }
+            for ( unsigned int i = 1; i < nof_threads; ++i ) {
+              auto& victim = queues[ ( tidx + i ) % nof_threads ];
+              std::lock_guard< std::mutex > lock( victim.lock );
+              if ( !victim.ranges.empty() ) {
+                range = victim.ranges.back();
+                victim.ranges.pop_back();
+                return true;
+              }
+            }
+            return false;
+          };
+
+          std::exception_ptr eptr = nullptr;
+          std::mutex eptr_lock;
+          auto worker = [&]( unsigned int tidx ) {
+            try {
+              this->stats_ptr->get_this_thread_stats().set_progress(
+                  thread_progress_type::find_off_paths );
+              [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "seeds-off-paths" );
+
+              auto traverser = this->create_traverser();
+              this->setup_traverser( traverser, reads, reads_index );
+              auto&& sink = fork_seed_callback( callback );
+              range_type range;
+              while ( next_range( tidx, range ) ) {
+                this->traverse_loci( traverser, range.first, range.second, sink );
+              }
+              flush_seeds( sink );
+            }
+            catch ( ... ) {
+              std::lock_guard< std::mutex > lock( eptr_lock );
+              if ( !eptr ) eptr = std::current_exception();
+              /* Drain the remaining ranges to stop other threads. */
+              for ( auto& q : queues ) {
+                std::lock_guard< std::mutex > qlock( q.lock );
+                q.ranges.clear();
+              }
+            }
+          };
+
+          std::vector< std::thread > workers;
+          workers.reserve( nof_threads );
+          for ( unsigned int i = 0; i < nof_threads; ++i ) workers.emplace_back( worker, i );
+          for ( auto& w : workers ) w.join();
+          if ( eptr ) std::rethrow_exception( eptr );
         }
 
           inline void
         seeds_all( readsrecord_type const& reads, readsindex_type& reads_index, traverser_type& traverser,
-                   std::function< void(typename traverser_type::output_type const &) > callback ) const
+                   callback_type callback ) const
+        {
+          this->template seeds_all< callback_type& >( reads, reads_index, traverser, callback );
+        }
+
+        template< typename TCallback >
+          inline void
+        seeds_all( readsrecord_type const& reads, readsindex_type& reads_index, traverser_type& traverser,
+                   TCallback&& callback ) const
         {
           this->seeds_on_paths( reads, reads_index, callback );
           this->setup_traverser( traverser, reads, reads_index );
@@ -1731,10 +2372,35 @@ namespace psi {
           this->stats_ptr->get_this_thread_stats().inc_chunks_done( );
         }
 
+          inline void
+        seeds_all( readsrecord_type const& reads, readsindex_type& reads_index,
+                   callback_type callback, unsigned int nof_threads ) const
+        {
+          this->template seeds_all< callback_type& >( reads, reads_index, callback, nof_threads );
+        }
+
+        template< typename TCallback >
+          inline void
+        seeds_all( readsrecord_type const& reads, readsindex_type& reads_index,
+                   TCallback&& callback, unsigned int nof_threads ) const
+        {
+          this->seeds_on_paths( reads, reads_index, callback, nof_threads );
+          this->seeds_off_paths( reads, reads_index, callback, nof_threads );
+          this->stats_ptr->get_this_thread_stats().inc_chunks_done( );
+        }
+
           inline void
         seeds_all( readsrecord_type const& reads, readsindex_type& reads_index, traverser_type& traverser,
-                   std::function< void(typename traverser_type::output_type const &) > callback1,
-                   std::function< void(typename traverser_type::output_type const &) > callback2 ) const
+                   callback_type callback1, callback_type callback2 ) const
+        {
+          this->template seeds_all< callback_type&, callback_type& >(
+              reads, reads_index, traverser, callback1, callback2 );
+        }
+
+        template< typename TCallback1, typename TCallback2 >
+          inline void
+        seeds_all( readsrecord_type const& reads, readsindex_type& reads_index, traverser_type& traverser,
+                   TCallback1&& callback1, TCallback2&& callback2 ) const
         {
           this->seeds_on_paths( reads, reads_index, callback1 );
           this->setup_traverser( traverser, reads, reads_index );
@@ -1743,10 +2409,20 @@ namespace psi {
         }
 
       private:
+        /* ====================  CONSTANTS     ======================================= */
+        /** @brief Number of starting loci ranges per thread in parallel traversal. */
+        constexpr static const unsigned int RANGES_PER_THREAD = 16;
+        /** @brief DNA characters by their ranks. */
+        constexpr static const char DNA[] = { 'A', 'C', 'G', 'T' };
         /* ====================  DATA MEMBERS  ======================================= */
         const graph_type* graph_ptr;
         std::vector< Position<> > starting_loci;
         pathindex_type pindex;  /**< @brief Genome-wide path index in lazy mode. */
+        /** @brief Bidirectional index of the paths for finding MEMs (see `create_mem_index`).
+         *  NOTE: SeqAn iterators require a non-const index; it is only read after creation. */
+        mutable memindex_type mindex;
+        lociindex_type lindex;  /**< @brief Index of the starting loci k-mers (see `create_loci_index`). */
+        snapshot_type snapshot;  /**< @brief Graph snapshot for traversals (see `create_graph_snapshot`). */
         KokkosHandler handler;
         crsmat_type distance_mat;
         unsigned int seed_len;
@@ -1785,6 +2461,348 @@ namespace psi {
           this->pindex.set_context( context );
           return context;
         }
+
+        /**
+         *  @brief  Split the starting loci into node-aligned ranges.
+         *
+         *  @param  n The approximate number of ranges.
+         *  @return the list of half-open ranges `[begin, end)` of starting loci indices.
+         *
+         *  The ranges are of roughly equal size and the loci on a node never fall into
+         *  two different ranges.
+         */
+        inline std::vector< std::pair< std::size_t, std::size_t > >
+        loci_ranges( std::size_t n ) const
+        {
+          std::vector< std::pair< std::size_t, std::size_t > > ranges;
+          auto total = this->starting_loci.size();
+          if ( total == 0 ) return ranges;
+          if ( n == 0 ) n = 1;
+          std::size_t rsize = ( total + n - 1 ) / n;
+          std::size_t begin = 0;
+          while ( begin < total ) {
+            std::size_t end = std::min( begin + rsize, total );
+            while ( end < total &&
+                    this->starting_loci[ end ].node_id() ==
+                    this->starting_loci[ end - 1 ].node_id() ) ++end;
+            ranges.emplace_back( begin, end );
+            begin = end;
+          }
+          return ranges;
+        }
+
+        /**
+         *  @brief  Estimate the number of non-zero entries of the distance index.
+         *
+         *  The loci in the distance range of a locus are stored as ranges of two
+         *  entries. It is one range on a linear sequence, and each branching edge
+         *  (i.e. an edge more than a spanning tree of the components) within `dmax`
+         *  loci ahead splits it into one more range. So, there are about `nof_loci +
+         *  dmax * nof_branches` ranges.
+         */
+          static inline std::size_t
+        estimate_dindex_nnz( std::size_t nof_loci, std::size_t nof_nodes,
+                             std::size_t nof_edges, std::size_t nof_comps, unsigned int dmax )
+        {
+          std::size_t nof_branches = nof_edges + nof_comps > nof_nodes ?
+              nof_edges + nof_comps - nof_nodes : 0;
+          return 2 * ( nof_loci + static_cast< std::size_t >( dmax ) * nof_branches );
+        }
+
+        /**
+         *  @brief  Build blocks by a pool of threads and pass them to callback in order.
+         *
+         *  @param  build The function building the block of the given index.
+         *  @param  callback The function consuming the built blocks (called in order).
+         *  @param  mem_est The estimated memory footprint of each block.
+         *  @param  n The number of blocks.
+         *  @param  nof_threads The number of worker threads.
+         *  @param  mem_limit The memory limit of blocks in flight.
+         *
+         *  Blocks are started in order, and a block is only started if the estimated
+         *  memory of the blocks in flight (started but not consumed yet) does not exceed
+         *  the limit, unless no block is in flight. Blocks are released right after they
+         *  are consumed by the callback which is called in the calling thread. The first
+         *  exception thrown by any thread is rethrown after all workers are joined.
+         */
+        template< typename TBuild, typename TCallback >
+          static inline void
+        build_blocks_parallel( TBuild& build, TCallback& callback,
+                               std::vector< std::size_t > const& mem_est, std::size_t n,
+                               unsigned int nof_threads, std::size_t mem_limit )
+        {
+          typedef decltype( build( 0 ) ) block_type;
+
+          std::vector< std::unique_ptr< block_type > > blocks( n );
+          std::mutex lock;
+          std::condition_variable cv;
+          std::size_t next = 0;        // the next block to be started
+          std::size_t in_flight = 0;   // estimated memory of blocks in flight
+          std::exception_ptr eptr = nullptr;
+
+          auto worker = [&]( ) {
+            while ( true ) {
+              std::size_t idx;
+              {
+                std::unique_lock< std::mutex > lk( lock );
+                cv.wait( lk, [&]() {
+                    return eptr || next == n || in_flight == 0 ||
+                        in_flight + mem_est[ next ] <= mem_limit;
+                  } );
+                if ( eptr || next == n ) return;
+                idx = next++;
+                in_flight += mem_est[ idx ];
+              }
+              try {
+                auto block = std::make_unique< block_type >( build( idx ) );
+                std::lock_guard< std::mutex > lk( lock );
+                blocks[ idx ] = std::move( block );
+              }
+              catch ( ... ) {
+                std::lock_guard< std::mutex > lk( lock );
+                if ( !eptr ) eptr = std::current_exception();
+              }
+              cv.notify_all();
+            }
+          };
+
+          std::vector< std::thread > workers;
+          workers.reserve( nof_threads );
+          for ( unsigned int i = 0; i < nof_threads; ++i ) workers.emplace_back( worker );
+
+          try {
+            for ( std::size_t idx = 0; idx < n; ++idx ) {
+              std::unique_ptr< block_type > block;
+              {
+                std::unique_lock< std::mutex > lk( lock );
+                cv.wait( lk, [&]() { return eptr || blocks[ idx ]; } );
+                if ( eptr ) break;
+                block = std::move( blocks[ idx ] );
+              }
+              callback( idx, *block );
+              block.reset();
+              {
+                std::lock_guard< std::mutex > lk( lock );
+                in_flight -= mem_est[ idx ];
+              }
+              cv.notify_all();
+            }
+          }
+          catch ( ... ) {
+            {
+              std::lock_guard< std::mutex > lk( lock );
+              if ( !eptr ) eptr = std::current_exception();
+            }
+            cv.notify_all();
+          }
+
+          for ( auto& w : workers ) w.join();
+          if ( eptr ) std::rethrow_exception( eptr );
+        }
+
+        /**
+         *  @brief  Traverse the graph from the starting loci in the given range.
+         *
+         *  @param  traverser The traverser bound to the reads chunk and its index.
+         *  @param  begin The index of the first starting locus.
+         *  @param  end The index past the last starting locus.
+         *  @param  callback The call back function applied on the found seeds.
+         *
+         *  The loci on the same node are traversed together in one run.
+         */
+        template< typename TCallback >
+        inline void
+        traverse_loci( traverser_type& traverser, std::size_t begin, std::size_t end,
+                       TCallback& callback ) const
+        {
+          auto&& thread_stats = this->stats_ptr->get_this_thread_stats();
+          for ( std::size_t idx = begin; idx < end; ++idx ) {
+            const auto& locus = this->starting_loci[ idx ];
+            traverser.add_locus( locus );
+            if ( idx + 1 < end &&
+                 this->starting_loci[ idx + 1 ].node_id() == locus.node_id() ) continue;
+
+            traverser.run( callback );
+            thread_stats.set_locus_idx( idx );
+          }
+        }
+
+        /**
+         *  @brief  Add the k-mers of the graph walks from a position to `pairs`.
+         *
+         *  @param  id The node ID of the position.
+         *  @param  offset The node offset of the position.
+         *  @param  depth The length of the walk so far.
+         *  @param  kmer The packed k-mer spelled by the walk so far.
+         *  @param  idx The index of the starting locus the walk starts from.
+         *  @param  pairs The k-mers paired with their starting loci indices.
+         *
+         *  The walks spelling a non-ACGT character are discarded.
+         */
+        inline void
+        add_kmers_at( id_type id, offset_type offset, unsigned int depth,
+                      typename lociindex_type::kmer_type kmer, std::size_t idx,
+                      std::vector< std::pair< typename lociindex_type::kmer_type,
+                                              std::size_t > >& pairs ) const
+        {
+          const auto& sequence = this->graph_ptr->node_sequence( id );
+          for ( ; offset < sequence.size() && depth < this->seed_len; ++offset, ++depth ) {
+            auto c = seqan2::ordValue( seqan2::Dna5( sequence[ offset ] ) );
+            if ( c > 3 ) return;
+            kmer = ( kmer << 2 ) | c;
+          }
+          if ( depth == this->seed_len ) {
+            pairs.emplace_back( kmer, idx );
+            return;
+          }
+          this->graph_ptr->for_each_edges_out(
+              id,
+              [&]( id_type to, typename graph_type::linktype_type ) {
+                this->add_kmers_at( to, 0, depth, kmer, idx, pairs );
+                return true;
+              } );
+        }
+
+        /**
+         *  @brief  Find seeds off paths by matching the starting loci index.
+         *
+         *  @param  reads The set of input reads.
+         *  @param  reads_index The reads index.
+         *  @param  callback The call back function applied on the found seeds.
+         *  @param  nof_threads The number of threads.
+         *
+         *  The loci index (see `create_loci_index`) and the reads index are descended
+         *  jointly. For multiple threads, the loci index is partitioned into the subtrees
+         *  rooted at a depth with enough nodes which are fetched by the threads from a
+         *  shared counter.
+         *
+         *  NOTE: The callback is called concurrently from worker threads when
+         *  `nof_threads` is more than one; it should be thread-safe.
+         */
+        template< typename TCallback >
+        inline void
+        seeds_off_loci_index( readsrecord_type const& reads, readsindex_type& reads_index,
+                              TCallback& callback, unsigned int nof_threads=1 ) const
+        {
+          typedef typename lociindex_type::range_type range_type;
+          typedef typename traverser_type::iterator_type iterator_type;
+
+          if ( this->lindex.empty() ) return;
+          if ( nof_threads > 1 ) create_index( reads_index );
+
+          std::vector< range_type > subtrees( 1, this->lindex.root_range() );
+          unsigned int plen = 0;
+          while ( nof_threads > 1 && subtrees.size() < nof_threads * SeedFinder::RANGES_PER_THREAD &&
+                  plen + 1 < this->lindex.get_k() ) {
+            std::vector< range_type > children;
+            for ( auto const& r : subtrees ) {
+              for ( unsigned int c = 0; c < 4; ++c ) {
+                auto child = this->lindex.child( r, plen, c );
+                if ( child.first <= child.second ) children.push_back( child );
+              }
+            }
+            subtrees.swap( children );
+            ++plen;
+          }
+
+          std::atomic< std::size_t > next_subtree( 0 );
+          std::exception_ptr eptr = nullptr;
+          std::mutex eptr_lock;
+          auto worker = [&]( ) {
+            try {
+              this->stats_ptr->get_this_thread_stats().set_progress(
+                  thread_progress_type::find_off_paths );
+              [[maybe_unused]] auto timer = this->stats_ptr->timeit_ts( "seeds-off-paths" );
+
+              auto&& sink = fork_seed_callback( callback );
+              std::size_t idx;
+              while ( ( idx = next_subtree++ ) < subtrees.size() ) {
+                iterator_type ritr( reads_index );
+                auto kmer = this->lindex.get_kmer( subtrees[ idx ].first );
+                unsigned int depth = 0;
+                for ( ; depth < plen; ++depth ) {
+                  if ( !go_down( ritr, SeedFinder::DNA[ this->lindex.char_at( kmer, depth ) ] ) ) break;
+                }
+                if ( depth < plen ) continue;
+                this->match_loci_kmers( reads, subtrees[ idx ], plen, ritr, sink );
+              }
+              flush_seeds( sink );
+            }
+            catch ( ... ) {
+              next_subtree = subtrees.size();  // stop other threads
+              std::lock_guard< std::mutex > lock( eptr_lock );
+              if ( !eptr ) eptr = std::current_exception();
+            }
+          };
+
+          if ( nof_threads <= 1 ) worker();
+          else {
+            std::vector< std::thread > workers;
+            workers.reserve( nof_threads );
+            for ( unsigned int i = 0; i < nof_threads; ++i ) workers.emplace_back( worker );
+            for ( auto& w : workers ) w.join();
+          }
+          if ( eptr ) std::rethrow_exception( eptr );
+        }
+
+        /**
+         *  @brief  Match a subtree of the starting loci index against the reads index.
+         *
+         *  @param  reads The set of input reads.
+         *  @param  range The range of the loci k-mers sharing their first `depth` characters.
+         *  @param  depth The length of the shared prefix.
+         *  @param  ritr The reads index iterator at the shared prefix.
+         *  @param  callback The call back function applied on the found seeds.
+         *
+         *  A range of a single k-mer is a unary path in the trie; the reads index iterator
+         *  goes down by its remaining characters without any branching.
+         */
+        template< typename TCallback >
+        inline void
+        match_loci_kmers( readsrecord_type const& reads, typename lociindex_type::range_type range,
+                          unsigned int depth, typename traverser_type::iterator_type ritr,
+                          TCallback& callback ) const
+        {
+          typedef typename traverser_type::stats_type traverser_stats_type;
+
+          unsigned int k = this->lindex.get_k();
+          if ( range.first == range.second ) {
+            auto kmer = this->lindex.get_kmer( range.first );
+            for ( ; depth < k; ++depth ) {
+              if ( !go_down( ritr, SeedFinder::DNA[ this->lindex.char_at( kmer, depth ) ] ) ) return;
+              traverser_stats_type::inc_total_nof_godowns();
+            }
+          }
+
+          if ( depth == k ) {
+            auto saPositions = getOccurrences( ritr.get_iter_() );
+            auto loci = this->lindex.occurrences( range );
+            traverser_stats_type::inc_total_seeds_off_paths( length( saPositions ) * length( loci ) );
+            for ( std::size_t j = 0; j < length( loci ); ++j ) {
+              const auto& locus = this->starting_loci[ loci[ j ].i1 ];
+              for ( std::size_t i = 0; i < length( saPositions ); ++i ) {
+                typename traverser_type::output_type hit;
+                hit.node_id = locus.node_id();
+                hit.node_offset = locus.offset();
+                hit.read_id = position_to_id( reads, saPositions[i].i1 );
+                hit.read_offset = position_to_offset( reads, saPositions[i] );
+                hit.match_len = k;
+                hit.gocc = length( saPositions );
+                callback( hit );
+              }
+            }
+            return;
+          }
+
+          for ( unsigned int c = 0; c < 4; ++c ) {
+            auto child = this->lindex.child( range, depth, c );
+            if ( child.first > child.second ) continue;
+            typename traverser_type::iterator_type citr( ritr );
+            if ( !go_down( citr, SeedFinder::DNA[ c ] ) ) continue;
+            traverser_stats_type::inc_total_nof_godowns();
+            this->match_loci_kmers( reads, child, depth + 1, std::move( citr ), callback );
+          }
+        }
     };
 }  /* --- end of namespace psi --- */
 
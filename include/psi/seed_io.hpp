@@ -0,0 +1,511 @@
+/**
+ *    @file  seed_io.hpp
+ *   @brief  Buffered reading and writing seed hits.
+ *
+ *  This header file defines the seed writer (sink) and reader (source) classes
+ *  storing/retrieving seed hits in binary files in one of the supported layouts.
+ *
+ *  @author  Ali Ghaffaari (\@cartoonist), <ali.ghaffaari@mpi-inf.mpg.de>
+ *
+ *  @internal
+ *       Created:  Thu Oct 15, 2026  10:12
+ *  Organization:  Max-Planck-Institut fuer Informatik
+ *     Copyright:  Copyright (c) 2026, Ali Ghaffaari
+ *
+ *  This source code is released under the terms of the MIT License.
+ *  See LICENSE file for more information.
+ */
+
+#ifndef PSI_SEED_IO_HPP__
+#define PSI_SEED_IO_HPP__
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+
+#include "seed.hpp"
+
+
+namespace psi {
+  /* Seed file layout tags */
+  /**
+   *  @brief  Plain layout tag.
+   *
+   *  Each seed hit is stored as a fixed-size record of four fields: node id, node
+   *  offset, read id, and read offset in this order (native byte order).
+   */
+  struct PlainLayout { };
+  /**
+   *  @brief  Compact layout tag.
+   *
+   *  The file starts with a header (magic string and version) followed by a series of
+   *  blocks. Each block begins with the payload size and the number of hits (64-bit
+   *  each). The hits in a block are sorted and grouped by read id; the read ids, read
+   *  offsets, and node ids are delta-encoded within the block, group, and group
+   *  respectively, and all values are stored as LEB128 varints (node id deltas are
+   *  zigzag encoded).
+   */
+  struct CompactLayout { };
+
+  namespace seed_io {
+    constexpr static const std::size_t DEFAULT_BUFFER_SIZE = 4 * 1024 * 1024;  /**< @brief in bytes */
+    constexpr static const std::size_t BUFFER_ALIGNMENT = 4096;
+    constexpr static const char COMPACT_MAGIC[] = "PSISEEDZ";
+    constexpr static const std::size_t COMPACT_MAGIC_LEN = sizeof( COMPACT_MAGIC ) - 1;
+    constexpr static const uint64_t COMPACT_VERSION = 1;
+    constexpr static const std::size_t MAX_VARINT_LEN = 10;  /**< @brief of a 64-bit integer */
+
+    struct FreeDeleter {
+      inline void operator()( char* ptr ) const { std::free( ptr ); }
+    };
+
+    typedef std::unique_ptr< char[], FreeDeleter > buffer_type;
+
+    /**
+     *  @brief  Allocate a buffer aligned to `BUFFER_ALIGNMENT`.
+     *
+     *  @param  size The minimum size of the buffer in bytes; it will be rounded up to
+     *               a multiple of the alignment.
+     */
+    inline buffer_type
+    aligned_buffer( std::size_t& size )
+    {
+      size = ( size + BUFFER_ALIGNMENT - 1 ) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+      if ( size == 0 ) size = BUFFER_ALIGNMENT;
+      auto ptr = static_cast< char* >( std::aligned_alloc( BUFFER_ALIGNMENT, size ) );
+      if ( ptr == nullptr ) throw std::bad_alloc();
+      return buffer_type( ptr );
+    }
+
+    inline char*
+    encode_varint( char* out, uint64_t value )
+    {
+      while ( value >= 0x80 ) {
+        *out++ = static_cast< char >( ( value & 0x7F ) | 0x80 );
+        value >>= 7;
+      }
+      *out++ = static_cast< char >( value );
+      return out;
+    }
+
+    inline char const*
+    decode_varint( char const* in, char const* end, uint64_t& value )
+    {
+      value = 0;
+      for ( unsigned int shift = 0; in != end && shift < 64; shift += 7 ) {
+        auto byte = static_cast< uint8_t >( *in++ );
+        value |= static_cast< uint64_t >( byte & 0x7F ) << shift;
+        if ( !( byte & 0x80 ) ) return in;
+      }
+      throw std::runtime_error( "malformed seed file: truncated varint" );
+    }
+
+    inline uint64_t
+    zigzag( int64_t value )
+    {
+      return ( static_cast< uint64_t >( value ) << 1 ) ^ static_cast< uint64_t >( value >> 63 );
+    }
+
+    inline int64_t
+    unzigzag( uint64_t value )
+    {
+      return static_cast< int64_t >( value >> 1 ) ^ -static_cast< int64_t >( value & 1 );
+    }
+  }  /* --- end of namespace seed_io --- */
+
+  template< typename TLayout = PlainLayout, typename TSeed = Seed<> >
+    class SeedWriter;
+
+  template< typename TLayout = PlainLayout, typename TSeed = Seed<> >
+    class SeedReader;
+
+  /**
+   *  @brief  Buffered seed writer (plain layout).
+   *
+   *  The seed hits are accumulated in a large aligned buffer which is written to the
+   *  output stream by one call when it is full.
+   *
+   *  NOTE: It is not thread-safe.
+   */
+  template< typename TSeed >
+    class SeedWriter< PlainLayout, TSeed > {
+      public:
+        /* === TYPE MEMBERS === */
+        typedef TSeed value_type;
+        typedef typename value_type::id_type id_type;
+        typedef typename value_type::offset_type offset_type;
+        /* === CONSTANTS === */
+        constexpr static const std::size_t RECORD_SIZE = 2 * sizeof( id_type ) + 2 * sizeof( offset_type );
+        /* === LIFECYCLE === */
+        SeedWriter( std::ostream& o, std::size_t bufsize=seed_io::DEFAULT_BUFFER_SIZE )
+          : out( o ), capacity( std::max( bufsize, RECORD_SIZE ) ), cursor( 0 ), count( 0 )
+        {
+          this->buffer = seed_io::aligned_buffer( this->capacity );
+          this->capacity -= this->capacity % RECORD_SIZE;
+        }
+
+        SeedWriter( SeedWriter const& ) = delete;
+        SeedWriter& operator=( SeedWriter const& ) = delete;
+
+        ~SeedWriter( ) noexcept
+        {
+          try {
+            this->flush();
+          }
+          catch ( ... ) { /* noop */ }
+        }
+        /* === OPERATORS === */
+          inline void
+        operator()( value_type const& hit )
+        {
+          this->push( hit );
+        }
+        /* === ACCESSORS === */
+          inline std::size_t
+        get_nof_seeds( ) const
+        {
+          return this->count;
+        }
+        /* === METHODS === */
+          inline void
+        push( value_type const& hit )
+        {
+          if ( this->cursor == this->capacity ) this->flush();
+          char* ptr = this->buffer.get() + this->cursor;
+          std::memcpy( ptr, &hit.node_id, sizeof( id_type ) );
+          ptr += sizeof( id_type );
+          std::memcpy( ptr, &hit.node_offset, sizeof( offset_type ) );
+          ptr += sizeof( offset_type );
+          std::memcpy( ptr, &hit.read_id, sizeof( id_type ) );
+          ptr += sizeof( id_type );
+          std::memcpy( ptr, &hit.read_offset, sizeof( offset_type ) );
+          this->cursor += RECORD_SIZE;
+          ++this->count;
+        }
+
+          inline void
+        flush( )
+        {
+          if ( this->cursor == 0 ) return;
+          this->out.write( this->buffer.get(), this->cursor );
+          this->cursor = 0;
+          if ( !this->out ) throw std::runtime_error( "failed to write seeds" );
+        }
+      private:
+        /* === DATA MEMBERS === */
+        std::ostream& out;
+        seed_io::buffer_type buffer;
+        std::size_t capacity;  /**< @brief in bytes */
+        std::size_t cursor;
+        std::size_t count;
+    };  /* --- end of template class SeedWriter --- */
+
+  /**
+   *  @brief  Buffered seed writer (compact layout).
+   *
+   *  The seed hits are accumulated in memory; each time the buffer is full, the hits
+   *  are sorted and encoded as one block into an aligned buffer which is written to
+   *  the output stream by one call.
+   *
+   *  NOTE: The order of hits is not preserved.
+   *
+   *  NOTE: It is not thread-safe.
+   */
+  template< typename TSeed >
+    class SeedWriter< CompactLayout, TSeed > {
+      public:
+        /* === TYPE MEMBERS === */
+        typedef TSeed value_type;
+        typedef typename value_type::id_type id_type;
+        typedef typename value_type::offset_type offset_type;
+        /* === CONSTANTS === */
+        constexpr static const std::size_t BLOCK_HEADER_SIZE = 2 * sizeof( uint64_t );
+        constexpr static const std::size_t MAX_HIT_SIZE = 5 * seed_io::MAX_VARINT_LEN;
+        /* === LIFECYCLE === */
+        SeedWriter( std::ostream& o, std::size_t bufsize=seed_io::DEFAULT_BUFFER_SIZE )
+          : out( o ), count( 0 )
+        {
+          std::size_t nof_hits = std::max< std::size_t >( bufsize / MAX_HIT_SIZE, 1 );
+          this->hits.reserve( nof_hits );
+          this->bufsize = BLOCK_HEADER_SIZE + nof_hits * MAX_HIT_SIZE;
+          this->buffer = seed_io::aligned_buffer( this->bufsize );
+          this->out.write( seed_io::COMPACT_MAGIC, seed_io::COMPACT_MAGIC_LEN );
+          this->out.write( reinterpret_cast< char const* >( &seed_io::COMPACT_VERSION ),
+                           sizeof( uint64_t ) );
+        }
+
+        SeedWriter( SeedWriter const& ) = delete;
+        SeedWriter& operator=( SeedWriter const& ) = delete;
+
+        ~SeedWriter( ) noexcept
+        {
+          try {
+            this->flush();
+          }
+          catch ( ... ) { /* noop */ }
+        }
+        /* === OPERATORS === */
+          inline void
+        operator()( value_type const& hit )
+        {
+          this->push( hit );
+        }
+        /* === ACCESSORS === */
+          inline std::size_t
+        get_nof_seeds( ) const
+        {
+          return this->count;
+        }
+        /* === METHODS === */
+          inline void
+        push( value_type const& hit )
+        {
+          if ( this->hits.size() == this->hits.capacity() ) this->flush();
+          this->hits.push_back( hit );
+          ++this->count;
+        }
+
+          inline void
+        flush( )
+        {
+          using seed_io::encode_varint;
+          using seed_io::zigzag;
+
+          if ( this->hits.empty() ) return;
+
+          std::sort( this->hits.begin(), this->hits.end(),
+                     []( value_type const& a, value_type const& b ) {
+                       return std::tie( a.read_id, a.read_offset, a.node_id, a.node_offset )
+                           < std::tie( b.read_id, b.read_offset, b.node_id, b.node_offset );
+                     } );
+
+          char* begin = this->buffer.get();
+          char* ptr = begin + BLOCK_HEADER_SIZE;
+          uint64_t pre_read_id = 0;
+          for ( auto gbegin = this->hits.begin(); gbegin != this->hits.end(); ) {
+            auto gend = std::find_if( gbegin, this->hits.end(),
+                                      [gbegin]( value_type const& h ) {
+                                        return h.read_id != gbegin->read_id;
+                                      } );
+            ptr = encode_varint( ptr, gbegin->read_id - pre_read_id );
+            ptr = encode_varint( ptr, gend - gbegin );
+            pre_read_id = gbegin->read_id;
+            uint64_t pre_read_offset = 0;
+            uint64_t pre_node_id = 0;
+            for ( ; gbegin != gend; ++gbegin ) {
+              ptr = encode_varint( ptr, gbegin->read_offset - pre_read_offset );
+              ptr = encode_varint( ptr, zigzag( static_cast< int64_t >( gbegin->node_id - pre_node_id ) ) );
+              ptr = encode_varint( ptr, gbegin->node_offset );
+              pre_read_offset = gbegin->read_offset;
+              pre_node_id = gbegin->node_id;
+            }
+          }
+          uint64_t header[ 2 ] = { static_cast< uint64_t >( ptr - begin ) - BLOCK_HEADER_SIZE,
+                                   this->hits.size() };
+          std::memcpy( begin, header, BLOCK_HEADER_SIZE );
+          this->out.write( begin, ptr - begin );
+          this->hits.clear();
+          if ( !this->out ) throw std::runtime_error( "failed to write seeds" );
+        }
+      private:
+        /* === DATA MEMBERS === */
+        std::ostream& out;
+        std::vector< value_type > hits;
+        seed_io::buffer_type buffer;
+        std::size_t bufsize;  /**< @brief in bytes */
+        std::size_t count;
+    };  /* --- end of template class SeedWriter --- */
+
+  /**
+   *  @brief  Buffered seed reader (plain layout).
+   */
+  template< typename TSeed >
+    class SeedReader< PlainLayout, TSeed > {
+      public:
+        /* === TYPE MEMBERS === */
+        typedef TSeed value_type;
+        typedef typename value_type::id_type id_type;
+        typedef typename value_type::offset_type offset_type;
+        /* === CONSTANTS === */
+        constexpr static const std::size_t RECORD_SIZE = SeedWriter< PlainLayout, TSeed >::RECORD_SIZE;
+        /* === LIFECYCLE === */
+        SeedReader( std::istream& i, std::size_t bufsize=seed_io::DEFAULT_BUFFER_SIZE )
+          : in( i ), capacity( std::max( bufsize, RECORD_SIZE ) ), cursor( 0 ), size( 0 )
+        {
+          this->buffer = seed_io::aligned_buffer( this->capacity );
+          this->capacity -= this->capacity % RECORD_SIZE;
+        }
+        /* === METHODS === */
+        /**
+         *  @brief  Read the next seed hit.
+         *
+         *  @param[out]  hit The read seed hit.
+         *  @return `false` if there is no more seed hits; otherwise `true`.
+         */
+          inline bool
+        next( value_type& hit )
+        {
+          if ( this->cursor == this->size && !this->fill() ) return false;
+          char const* ptr = this->buffer.get() + this->cursor;
+          std::memcpy( &hit.node_id, ptr, sizeof( id_type ) );
+          ptr += sizeof( id_type );
+          std::memcpy( &hit.node_offset, ptr, sizeof( offset_type ) );
+          ptr += sizeof( offset_type );
+          std::memcpy( &hit.read_id, ptr, sizeof( id_type ) );
+          ptr += sizeof( id_type );
+          std::memcpy( &hit.read_offset, ptr, sizeof( offset_type ) );
+          this->cursor += RECORD_SIZE;
+          return true;
+        }
+
+        template< typename TCallback >
+          inline void
+        for_each( TCallback callback )
+        {
+          value_type hit;
+          while ( this->next( hit ) ) callback( hit );
+        }
+      private:
+        /* === DATA MEMBERS === */
+        std::istream& in;
+        seed_io::buffer_type buffer;
+        std::size_t capacity;  /**< @brief in bytes */
+        std::size_t cursor;
+        std::size_t size;
+        /* === METHODS === */
+          inline bool
+        fill( )
+        {
+          this->in.read( this->buffer.get(), this->capacity );
+          this->size = this->in.gcount();
+          this->cursor = 0;
+          if ( this->size % RECORD_SIZE != 0 ) {
+            throw std::runtime_error( "malformed seed file: truncated record" );
+          }
+          return this->size != 0;
+        }
+    };  /* --- end of template class SeedReader --- */
+
+  /**
+   *  @brief  Buffered seed reader (compact layout).
+   *
+   *  NOTE: The seed hits are retrieved in the order they are stored; i.e. sorted by
+   *  read id within each block.
+   */
+  template< typename TSeed >
+    class SeedReader< CompactLayout, TSeed > {
+      public:
+        /* === TYPE MEMBERS === */
+        typedef TSeed value_type;
+        typedef typename value_type::id_type id_type;
+        typedef typename value_type::offset_type offset_type;
+        /* === CONSTANTS === */
+        constexpr static const std::size_t BLOCK_HEADER_SIZE = SeedWriter< CompactLayout, TSeed >::BLOCK_HEADER_SIZE;
+        /* === LIFECYCLE === */
+        SeedReader( std::istream& i, std::size_t=seed_io::DEFAULT_BUFFER_SIZE )
+          : in( i ), cursor( 0 )
+        {
+          char magic[ seed_io::COMPACT_MAGIC_LEN ];
+          uint64_t version = 0;
+          this->in.read( magic, seed_io::COMPACT_MAGIC_LEN );
+          this->in.read( reinterpret_cast< char* >( &version ), sizeof( uint64_t ) );
+          if ( !this->in ||
+               std::memcmp( magic, seed_io::COMPACT_MAGIC, seed_io::COMPACT_MAGIC_LEN ) != 0 ) {
+            throw std::runtime_error( "not a compact seed file" );
+          }
+          if ( version != seed_io::COMPACT_VERSION ) {
+            throw std::runtime_error( "unsupported compact seed file version" );
+          }
+        }
+        /* === METHODS === */
+        /**
+         *  @brief  Read the next seed hit.
+         *
+         *  @param[out]  hit The read seed hit.
+         *  @return `false` if there is no more seed hits; otherwise `true`.
+         */
+          inline bool
+        next( value_type& hit )
+        {
+          if ( this->cursor == this->hits.size() && !this->fill() ) return false;
+          hit = this->hits[ this->cursor++ ];
+          return true;
+        }
+
+        template< typename TCallback >
+          inline void
+        for_each( TCallback callback )
+        {
+          value_type hit;
+          while ( this->next( hit ) ) callback( hit );
+        }
+      private:
+        /* === DATA MEMBERS === */
+        std::istream& in;
+        std::vector< char > payload;
+        std::vector< value_type > hits;
+        std::size_t cursor;
+        /* === METHODS === */
+          inline bool
+        fill( )
+        {
+          using seed_io::decode_varint;
+          using seed_io::unzigzag;
+
+          uint64_t header[ 2 ];
+          this->in.read( reinterpret_cast< char* >( header ), BLOCK_HEADER_SIZE );
+          if ( this->in.gcount() == 0 ) return false;
+          if ( static_cast< std::size_t >( this->in.gcount() ) != BLOCK_HEADER_SIZE ) {
+            throw std::runtime_error( "malformed seed file: truncated block header" );
+          }
+          this->payload.resize( header[ 0 ] );
+          this->in.read( this->payload.data(), header[ 0 ] );
+          if ( static_cast< uint64_t >( this->in.gcount() ) != header[ 0 ] ) {
+            throw std::runtime_error( "malformed seed file: truncated block" );
+          }
+
+          this->hits.clear();
+          this->hits.reserve( header[ 1 ] );
+          this->cursor = 0;
+          char const* ptr = this->payload.data();
+          char const* end = ptr + this->payload.size();
+          uint64_t read_id = 0;
+          while ( ptr != end ) {
+            uint64_t delta;
+            uint64_t gsize;
+            ptr = decode_varint( ptr, end, delta );
+            ptr = decode_varint( ptr, end, gsize );
+            read_id += delta;
+            uint64_t read_offset = 0;
+            uint64_t node_id = 0;
+            for ( uint64_t i = 0; i < gsize; ++i ) {
+              uint64_t value;
+              value_type hit{};
+              ptr = decode_varint( ptr, end, value );
+              read_offset += value;
+              ptr = decode_varint( ptr, end, value );
+              node_id += unzigzag( value );
+              ptr = decode_varint( ptr, end, value );
+              hit.node_id = node_id;
+              hit.node_offset = value;
+              hit.read_id = read_id;
+              hit.read_offset = read_offset;
+              this->hits.push_back( hit );
+            }
+          }
+          if ( this->hits.size() != header[ 1 ] ) {
+            throw std::runtime_error( "malformed seed file: inconsistent block" );
+          }
+          return !this->hits.empty();
+        }
+    };  /* --- end of template class SeedReader --- */
+}  /* --- end of namespace psi --- */
+
+#endif  /* --- #ifndef PSI_SEED_IO_HPP__ --- */
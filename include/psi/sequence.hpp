@@ -23,6 +23,9 @@
 #include <fstream>
 #include <stdexcept>
 #include <memory>
+#include <cstdint>
+#include <cassert>
+#include <limits>
 
 #include <seqan/seq_io.h>
 #include <kseq++/seqio.hpp>
@@ -1623,6 +1626,245 @@ namespace psi {
       return i;
     }
 
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 uint128_type;
+#endif
+
+  /**
+   *  @brief  DNA k-mer packed in a single machine word.
+   *
+   *  Each character occupies two bits and the first character is stored in the most
+   *  significant bits; so the lexicographical order of k-mers is the numerical order
+   *  of their words. Incrementing the k-mer at any position, including the carry
+   *  over, is a single addition. The word type determines the maximum k-mer length;
+   *  i.e. 32 for 64-bit and 64 for 128-bit words.
+   */
+  template< typename TWord = std::uint64_t >
+    class PackedKmer {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef TWord word_type;
+        typedef std::size_t size_type;
+        typedef seqan2::Dna value_type;
+        /* ====================  CONSTANTS     ======================================= */
+        constexpr static const unsigned int WIDTH = 2;
+        constexpr static const size_type CAPACITY = sizeof( word_type ) * 8 / WIDTH;
+        constexpr static const size_type npos = std::numeric_limits< size_type >::max();
+        /* ====================  LIFECYCLE     ======================================= */
+        constexpr PackedKmer( size_type k=0, word_type value=0 )
+          : k( k ), value( value & PackedKmer::mask( k ) )
+        {
+          assert( k <= CAPACITY );
+        }
+        /* ====================  ACCESSORS     ======================================= */
+          constexpr inline size_type
+        length( ) const
+        {
+          return this->k;
+        }
+
+          constexpr inline word_type
+        get_value( ) const
+        {
+          return this->value;
+        }
+        /* ====================  MUTATORS      ======================================= */
+          constexpr inline void
+        set_value( word_type v )
+        {
+          this->value = v & PackedKmer::mask( this->k );
+        }
+
+        /**
+         *  @brief  Set the value of the k-mer to `prefix` followed by all 'A'.
+         *
+         *  @param  prefix The packed prefix.
+         *  @param  plen The length of the prefix.
+         */
+          constexpr inline void
+        set_prefix( word_type prefix, size_type plen )
+        {
+          assert( plen <= this->k );
+          this->set_value( plen == 0 ? 0 : prefix << ( WIDTH * ( this->k - plen ) ) );
+        }
+
+          constexpr inline void
+        set( size_type pos, unsigned int c )
+        {
+          auto s = this->shift( pos );
+          this->value = ( this->value & ~( word_type( 3 ) << s ) ) | ( word_type( c & 3 ) << s );
+        }
+        /* ====================  OPERATORS     ======================================= */
+          constexpr inline unsigned int
+        get( size_type pos ) const
+        {
+          return static_cast< unsigned int >( ( this->value >> this->shift( pos ) ) & 3 );
+        }
+
+          inline value_type
+        operator[]( size_type pos ) const
+        {
+          return value_type( this->get( pos ) );
+        }
+
+          constexpr inline bool
+        operator==( PackedKmer const& other ) const
+        {
+          return this->k == other.k && this->value == other.value;
+        }
+
+          constexpr inline bool
+        operator!=( PackedKmer const& other ) const
+        {
+          return !( *this == other );
+        }
+        /* ====================  METHODS       ======================================= */
+        /**
+         *  @brief  Get next lexicographical k-mer by incrementing at a specific position.
+         *
+         *  @param  pos The pos of the character which should be incremented.
+         *  @param  continuous Do not reset characters after `pos` to 'A' if true.
+         *  @return The smallest position at which the character is modified, or `npos`
+         *          if there is no next k-mer.
+         *
+         *  It behaves exactly like `increment_kmer` on strings in constant time.
+         */
+          constexpr inline size_type
+        increment( size_type pos, bool continuous=false )
+        {
+          assert( pos < this->k );
+          auto s = this->shift( pos );
+          if ( !continuous ) this->value &= ~PackedKmer::mask( this->k - 1 - pos );
+          word_type prefix = this->value >> s;
+          if ( prefix == PackedKmer::mask( pos + 1 ) ) {  // all 'T' up to `pos`
+            this->value &= PackedKmer::mask( this->k - 1 - pos );
+            return npos;
+          }
+          word_type next = this->value + ( word_type( 1 ) << s );
+          auto diff = next ^ this->value;
+          this->value = next;
+          return this->k - 1 - PackedKmer::msb( diff ) / WIDTH;
+        }
+
+          constexpr inline size_type
+        increment( )
+        {
+          return this->increment( this->k - 1 );
+        }
+      private:
+        /* ====================  METHODS       ======================================= */
+        /**
+         *  @brief  Get the word with `n` lowest characters set.
+         */
+          constexpr static inline word_type
+        mask( size_type n )
+        {
+          return n >= CAPACITY ? ~word_type( 0 ) : ( word_type( 1 ) << ( WIDTH * n ) ) - 1;
+        }
+
+        /**
+         *  @brief  Index of the most significant set bit of a non-zero word.
+         */
+          constexpr static inline unsigned int
+        msb( word_type x )
+        {
+          if constexpr ( sizeof( word_type ) > sizeof( unsigned long long int ) ) {
+            unsigned long long int hi = static_cast< unsigned long long int >( x >> 64 );
+            if ( hi ) return 127 - __builtin_clzll( hi );
+            return 63 - __builtin_clzll( static_cast< unsigned long long int >( x ) );
+          }
+          else {
+            return 63 - __builtin_clzll( x );
+          }
+        }
+
+          constexpr inline unsigned int
+        shift( size_type pos ) const
+        {
+          return WIDTH * ( this->k - 1 - pos );
+        }
+        /* ====================  DATA MEMBERS  ======================================= */
+        size_type k;
+        word_type value;
+    };  /* --- end of template class PackedKmer --- */
+
+  template< typename TWord >
+      constexpr inline typename PackedKmer< TWord >::size_type
+    length( PackedKmer< TWord > const& kmer )
+    {
+      return kmer.length();
+    }
+
+  /**
+   *  @brief  Set the prefix of the k-mer with the given packed value and the rest to 'A'.
+   */
+  template< typename TWord >
+      inline void
+    assign_kmer_prefix( PackedKmer< TWord >& kmer, std::size_t prefix, std::size_t plen )
+    {
+      kmer.set_prefix( prefix, plen );
+    }
+
+  template< typename TText >
+      inline void
+    assign_kmer_prefix( TText& str, std::size_t prefix, std::size_t plen )
+    {
+      for ( std::size_t i = length( str ); i > plen; --i ) str[ i - 1 ] = 'A';
+      for ( std::size_t i = plen; i > 0; --i ) {
+        str[ i - 1 ] = static_cast< unsigned int >( prefix & 3 );
+        prefix >>= 2;
+      }
+    }
+
+  /**
+   *  @brief  Get the packed value of the first `plen` characters of the k-mer.
+   */
+  template< typename TWord >
+      inline std::uint64_t
+    kmer_prefix_code( PackedKmer< TWord > const& kmer, std::size_t plen )
+    {
+      assert( plen <= 32 && plen <= length( kmer ) );
+      return static_cast< std::uint64_t >(
+          kmer.get_value() >> ( PackedKmer< TWord >::WIDTH * ( length( kmer ) - plen ) ) );
+    }
+
+  template< typename TText >
+      inline std::uint64_t
+    kmer_prefix_code( TText const& str, std::size_t plen )
+    {
+      assert( plen <= 32 && plen <= length( str ) );
+      std::uint64_t code = 0;
+      for ( std::size_t i = 0; i < plen; ++i ) code = ( code << 2 ) | ordValue( str[ i ] );
+      return code;
+    }
+
+  /**
+   *  @brief  Call `func` with an all-'A' k-mer of length `k` of the most compact type.
+   *
+   *  The k-mer is a `PackedKmer` if it fits in a (64-bit or 128-bit) word; otherwise
+   *  it is a `seqan2::DnaString`.
+   */
+  template< typename TFunc >
+      inline void
+    with_kmer( std::size_t k, TFunc&& func )
+    {
+      if ( k <= PackedKmer<>::CAPACITY ) {
+        PackedKmer<> kmer( k );
+        func( kmer );
+        return;
+      }
+#ifdef __SIZEOF_INT128__
+      if ( k <= PackedKmer< uint128_type >::CAPACITY ) {
+        PackedKmer< uint128_type > kmer( k );
+        func( kmer );
+        return;
+      }
+#endif
+      seqan2::DnaString kmer;
+      for ( std::size_t i = 0; i < k; ++i ) appendValue( kmer, 'A' );
+      func( kmer );
+    }
+
   /**
    *  @brief  Get next lexicographical k-mer in a specific position in the string.
    *
@@ -1648,11 +1890,7 @@ namespace psi {
       // `continuous = true` means that the k-mer is continuously incremented so
       // far. So, there is no need to reset characters at positions > `pos`.
       if ( !continuous ) {
-        // TODO: We can optimise this part by defining a `Kmer` class where all
-        // elements after the specified pointer will be 'A' and we just need to
-        // move the pointer back and forth. Only in the latter case (moving
-        // forward) rewriting 'A' is required avoiding all unnecessary checks.
-        // TODO: This part can be optimised further by SIMD vectorisation.
+        // NOTE: See `PackedKmer` for a constant-time version of this function.
         for( std::size_t i = length( str ) - 1; i > pos; --i ) {
           if ( str[i] != min_value ) str[i] = min_value;
         }
@@ -1673,6 +1911,21 @@ namespace psi {
       return increment_kmer( str, length(str) - 1 );
     }
 
+  template< typename TWord >
+      constexpr inline typename PackedKmer< TWord >::size_type
+    increment_kmer( PackedKmer< TWord >& kmer, typename PackedKmer< TWord >::size_type pos,
+        bool continuous=false )
+    {
+      return kmer.increment( pos, continuous );
+    }
+
+  template< typename TWord >
+      constexpr inline typename PackedKmer< TWord >::size_type
+    increment_kmer( PackedKmer< TWord >& kmer )
+    {
+      return kmer.increment();
+    }
+
   /**
    *  @brief  Add any k-mers from the given string set with `step` distance to seed set.
    *
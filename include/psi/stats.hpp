@@ -21,6 +21,7 @@
 
 #include <chrono>
 #include <unordered_map>
+#include <mutex>
 #include <cassert>
 
 #include "base.hpp"
@@ -186,6 +187,10 @@ namespace psi {
    *
    *  Measure the time period between its instantiation and destruction. The timers are
    *  kept in static table hashed by the timer name.
+   *
+   *  NOTE: Accessing the timers table through the class interface is thread-safe.
+   *  However, iterating over the table returned by `get_timers` is not; it should be
+   *  done when no other thread is running a timer.
    */
   template< typename TClock = CpuClock >
     class Timer
@@ -261,6 +266,7 @@ namespace psi {
         Timer( const std::string& name )
         {
           this->timer_name = name;
+          std::lock_guard< std::mutex > lock( get_lock() );
           auto found = get_timers().find( this->timer_name );
           if ( found != get_timers().end() ) {
             assert( found->second.end >= found->second.start );
@@ -276,6 +282,7 @@ namespace psi {
          */
         ~Timer()
         {
+          std::lock_guard< std::mutex > lock( get_lock() );
           get_timers()[ this->timer_name ].end = clock_type::now();
         }  /* -----  end of method ~Timer  (destructor)  ----- */
         /* ====================  METHODS       ======================================= */
@@ -289,6 +296,29 @@ namespace psi {
           return timers;
         }  /* -----  end of method get_timers  ----- */
 
+        /**
+         *  @brief  static getter function for the lock guarding the timers table.
+         */
+          static inline std::mutex&
+        get_lock( )
+        {
+          static std::mutex timers_lock;
+          return timers_lock;
+        }  /* -----  end of method get_lock  ----- */
+
+        /**
+         *  @brief  Get a copy of the timer period by name.
+         *
+         *  @param  name The name of the timer.
+         *  @return the time period of the requested timer.
+         */
+          static inline TimePeriod
+        get_period( const std::string& name )
+        {
+          std::lock_guard< std::mutex > lock( get_lock() );
+          return get_timers()[ name ];
+        }  /* -----  end of method get_period  ----- */
+
         /**
          *  @brief  Get the timer duration by name.
          *
@@ -300,7 +330,7 @@ namespace psi {
           static inline duration_type
         get_duration( const std::string& name )
         {
-          return get_timers()[ name ].duration();
+          return get_period( name ).duration();
         }  /* -----  end of method get_duration  ----- */
 
         /**
@@ -314,7 +344,7 @@ namespace psi {
           static inline rep_type
         get_duration_rep( const std::string& name )
         {
-          return get_timers()[ name ].rep();
+          return get_period( name ).rep();
         }  /* -----  end of method get_duration  ----- */
 
         /**
@@ -328,7 +358,7 @@ namespace psi {
           static inline std::string
         get_duration_str( const std::string& name )
         {
-          return get_timers()[ name ].str();
+          return get_period( name ).str();
         }  /* -----  end of method get_duration  ----- */
 
         /**
@@ -341,7 +371,7 @@ namespace psi {
           static inline duration_type
         get_lap_duration( const std::string& name )
         {
-          return get_timers()[ name ].get_lap().duration();
+          return get_period( name ).get_lap().duration();
         }  /* -----  end of method get_lap  ----- */
 
         /**
@@ -354,7 +384,7 @@ namespace psi {
           static inline rep_type
         get_lap_rep( const std::string& name )
         {
-          return get_timers()[ name ].get_lap().rep();
+          return get_period( name ).get_lap().rep();
         }  /* -----  end of method get_lap  ----- */
 
         /**
@@ -367,7 +397,7 @@ namespace psi {
           static inline std::string
         get_lap_str( const std::string& name )
         {
-          return get_timers()[ name ].get_lap().str();
+          return get_period( name ).get_lap().str();
         }  /* -----  end of method get_lap  ----- */
       protected:
         /* ====================  DATA MEMBERS  ======================================= */
@@ -420,6 +450,10 @@ namespace psi {
       {
         return std::unordered_map< std::string, TimePeriod >{};
       }
+      constexpr static inline TimePeriod get_period( const std::string& )
+      {
+        return TimePeriod();
+      }
       constexpr static inline duration_type get_duration( const std::string& )
       {
         return traits_type::zero_duration;
@@ -40,6 +40,24 @@ namespace psi {
       public:
         typedef TraverserDFS< TGraph, TIndex, ExactMatching, TStatsSpec > Type;
     };  /* ----------  end of template class Traverser  ---------- */
+
+  template< typename TGraph, typename TIndex, typename TStatsSpec >
+    class Traverser< TGraph, TIndex, BFS, ApproxMatching, TStatsSpec > {
+      public:
+        typedef TraverserBFS< TGraph, TIndex, ApproxMatching, TStatsSpec > Type;
+    };  /* ----------  end of template class Traverser  ---------- */
+
+  template< typename TGraph, typename TIndex, typename TStatsSpec >
+    class Traverser< TGraph, TIndex, DFS, ApproxMatching, TStatsSpec > {
+      public:
+        typedef TraverserDFS< TGraph, TIndex, ApproxMatching, TStatsSpec > Type;
+    };  /* ----------  end of template class Traverser  ---------- */
+
+  template< typename TGraph, typename TIndex, typename TStatsSpec >
+    class Traverser< TGraph, TIndex, DFS, EditMatching, TStatsSpec > {
+      public:
+        typedef TraverserDFS< TGraph, TIndex, EditMatching, TStatsSpec > Type;
+    };  /* ----------  end of template class Traverser  ---------- */
 }  /* --- end of namespace psi --- */
 
 #endif  /* --- #ifndef PSI_TRAVERSER_HPP__ --- */
@@ -27,10 +27,13 @@
 #include <cmath>
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <functional>
+#include <type_traits>
 
 #include "graph.hpp"
 #include "graph_iter.hpp"
+#include "graph_snapshot.hpp"
 #include "sequence.hpp"
 #include "index.hpp"
 #include "index_iter.hpp"
@@ -51,20 +54,29 @@ namespace psi {
   template< typename TGraph, typename TIter, std::size_t MaxMismatches >
     struct MatchingTraits {
       static const std::size_t max_mismatches = MaxMismatches;
+      /**
+       *  @brief  Traversal state.
+       *
+       *  It only holds the loci, the depth and the remaining mismatches so that it is
+       *  trivially copyable. The node of the current locus `cpos` is the node handle
+       *  in the graph view being traversed (see `node_handle`). The reads index
+       *  iterator of a state is kept by the traverser in a side pool at the same slot
+       *  as the state (see `TraverserBase::state_iters`); so the iterators are only
+       *  copied when the states branch. Since they are copied, they should not carry a
+       *  history (i.e. use a history-free iterator such as
+       *  `TopDownFine< seqan2::Preorder >` rather than a `ParentLinks` one).
+       */
       typedef struct State {
-        typedef typename seqan2::Container< TIter >::Type TIndex;
-
-        TIter iter;
-        unsigned char mismatches;
         Position<> spos;
         Position<> cpos;
-        size_t depth;
+        std::uint32_t depth;
+        unsigned char mismatches;
         bool end;
 
-        State( TIndex* index, unsigned char mm,
+        State( unsigned char mm,
             typename TGraph::id_type sid, typename TGraph::offset_type soffset,
             typename TGraph::id_type cid, typename TGraph::offset_type coffset, size_t d )
-          : iter( *index ), mismatches( mm ), depth( d ), end( false )
+          : depth( d ), mismatches( mm ), end( false )
         {
           spos.set_node_id( sid );
           spos.set_offset( soffset );
@@ -72,19 +84,17 @@ namespace psi {
           cpos.set_offset( coffset );
         }
 
-        State( TIndex* index, unsigned char mm,
+        State( unsigned char mm,
             typename TGraph::id_type sid, typename TGraph::offset_type soffset, size_t d )
-          : State( index, mm, sid, soffset, sid, soffset, d )
+          : State( mm, sid, soffset, sid, soffset, d )
         { }
 
-        State( TIndex* index, unsigned char mm,
-            Position<> sp, Position<> cp, size_t d )
-          : iter( *index ), mismatches( mm ),
-          spos( sp ), cpos( cp ), depth( d ), end( false )
+        State( unsigned char mm, Position<> sp, Position<> cp, size_t d )
+          : spos( sp ), cpos( cp ), depth( d ), mismatches( mm ), end( false )
         { }
 
-        State( TIndex* index, unsigned char mm, Position<> sp, size_t d )
-          : State( index, mm, sp, sp, d )
+        State( unsigned char mm, Position<> sp, size_t d )
+          : State( mm, sp, sp, d )
         { }
 
         State( State const& ) = default;
@@ -93,6 +103,8 @@ namespace psi {
         State& operator=( State&& ) = default;
         ~State( ) = default;
       } TState;
+      static_assert( std::is_trivially_copyable< TState >::value,
+                     "traversal states should be trivially copyable" );
     };
 
   template< typename TGraph, typename TIter >
@@ -100,6 +112,46 @@ namespace psi {
   template< typename TGraph, typename TIter >
     using ApproxMatching = MatchingTraits< TGraph, TIter, 3 >;
 
+  /**
+   *  @brief  Matching traits for seeds within an edit distance.
+   *
+   *  Each state aligns one candidate pattern against the graph walk starting from
+   *  its starting locus. The last column of the dynamic programming matrix is kept
+   *  bit-parallel (Myers' algorithm) in `pv` and `mv`: the vertical positive and
+   *  negative deltas. The last row of the column in the error budget is tracked in
+   *  `active` (Ukkonen's cut-off) instead of computing the column minimum; the state
+   *  is dead when there is no such row. The pattern should not be longer than
+   *  `max_pattern_len`.
+   */
+  template< typename TGraph, typename TIter, std::size_t MaxErrors >
+    struct EditMatchingTraits {
+      static const std::size_t max_mismatches = MaxErrors;
+      static const std::size_t max_pattern_len = 64;
+      typedef struct State {
+        Position<> spos;             /**< @brief Starting locus. */
+        Position<> cpos;             /**< @brief Current locus (by node handle). */
+        std::size_t hit;             /**< @brief Index of the hit record of the state. */
+        std::uint64_t pv;            /**< @brief Vertical positive deltas. */
+        std::uint64_t mv;            /**< @brief Vertical negative deltas. */
+        std::uint32_t score;         /**< @brief Edit distance of the whole pattern. */
+        std::uint32_t depth;         /**< @brief Length of the walk so far. */
+        unsigned char active;        /**< @brief Last row of the column in the error budget. */
+        unsigned char mismatches;    /**< @brief Remaining error budget at `active` plus one. */
+        bool end;
+
+        State( Position<> sp, std::size_t h, unsigned int plen, unsigned char mm )
+          : spos( sp ), cpos( sp ), hit( h ),
+          pv( plen < 64 ? ( std::uint64_t( 1 ) << plen ) - 1 : ~std::uint64_t( 0 ) ),
+          mv( 0 ), score( plen ), depth( 0 ),
+          active( mm == 0 ? 0 : std::min( plen, mm - 1u ) ), mismatches( mm - active ),
+          end( false )
+        { }
+      } TState;
+    };
+
+  template< typename TGraph, typename TIter >
+    using EditMatching = EditMatchingTraits< TGraph, TIter, 3 >;
+
   /**
    *  @brief  TraverserStats template class.
    *
@@ -292,6 +344,7 @@ namespace psi {
         /* ====================  TYPEDEFS      ======================================= */
         typedef Seed<> output_type;
         typedef TGraph graph_type;
+        typedef GraphSnapshot< graph_type > snapshot_type;
         typedef TIndex index_type;
         typedef typename graph_type::id_type id_type;
         typedef typename graph_type::offset_type offset_type;
@@ -309,7 +362,8 @@ namespace psi {
         /* ====================  LIFECYCLE      ====================================== */
         TraverserBase( const graph_type* g, const records_type* r, TIndex* index,
             unsigned int len )
-          : graph_ptr( g ), reads( r ), reads_index( index ), seed_len( len )
+          : graph_ptr( g ), snapshot_ptr( nullptr ), reads( r ), reads_index( index ),
+          seed_len( len )
         { }
 
         TraverserBase( const graph_type* g, unsigned int len )
@@ -329,6 +383,15 @@ namespace psi {
           return this->graph_ptr;
         }
 
+        /**
+         *  @brief  getter function for snapshot_ptr.
+         */
+          inline const snapshot_type*
+        get_snapshot_ptr( ) const
+        {
+          return this->snapshot_ptr;
+        }
+
         /**
          *  @brief  getter function for reads.
          */
@@ -365,6 +428,18 @@ namespace psi {
           this->graph_ptr = value;
         }
 
+        /**
+         *  @brief  setter function for snapshot_ptr.
+         *
+         *  The traversal runs on the snapshot if it is set; otherwise on the graph. The
+         *  snapshot should be taken from the same graph.
+         */
+          inline void
+        set_snapshot_ptr( const snapshot_type* value )
+        {
+          this->snapshot_ptr = value;
+        }
+
         /**
          *  @brief  setter function for reads.
          */
@@ -396,35 +471,102 @@ namespace psi {
         add_locus( Position<> p )
         {
           this->states.emplace_back(
-              this->reads_index,
               max_mismatches + 1,
               std::move( p ),
               0 );
+          this->state_iters.emplace_back( *this->reads_index );
         }
 
           inline void
         add_locus( id_type id, offset_type offset )
         {
           this->states.emplace_back(
-              this->reads_index,
               max_mismatches + 1,
               id,
               offset,
               0 );
+          this->state_iters.emplace_back( *this->reads_index );
         }
 
           inline void
         states_reserve( size_t size )
         {
           this->states.reserve( size );
+          this->state_iters.reserve( size );
         }
       protected:
         /* ====================  DATA MEMBERS  ======================================= */
         const graph_type* graph_ptr;   /**< @brief Pointer to variation graph. */
+        const snapshot_type* snapshot_ptr;  /**< @brief Pointer to graph snapshot (optional). */
         const records_type* reads;     /**< @brief Pointer to reads record. */
         TIndex* reads_index;           /**< @brief Pointer to reads index. */
         unsigned int seed_len;         /**< @brief Seed length. */
+        /**
+         *  @brief  State pool.
+         *
+         *  It is cleared but not released at the end of each run, so the storage is
+         *  reused by the next runs as long as the traverser lives; e.g. for a chunk.
+         */
         std::vector< typename traits_type::TState > states;
+        /**
+         *  @brief  Reads index iterators of the states in the pool (side pool).
+         *
+         *  The iterator of `states[ i ]` is `state_iters[ i ]`; they are added, moved
+         *  and removed together.
+         */
+        std::vector< iterator_type > state_iters;
+        /* ====================  METHODS       ======================================= */
+        /**
+         *  @brief  Branch on substitution of a graph character in the reads index.
+         *
+         *  @param  parent The state right before matching `c`.
+         *  @param  piter The reads index iterator of `parent`.
+         *  @param  c The graph character at `parent.cpos`.
+         *  @param  seqlen The length of the node sequence `parent.cpos` is on.
+         *
+         *  Add a state for each nucleotide other than `c` by which the reads index
+         *  iterator of `parent` can go down, at the cost of one mismatch. The caller
+         *  should check that the parent has a mismatch left to spend before calling, so
+         *  that the iterator is not copied in vain. The parent is taken by value and its
+         *  iterator is copied before the first branch is added, since they might be
+         *  elements of the pools.
+         */
+          inline void
+        add_substitutions( typename traits_type::TState parent, iterator_type const& piter,
+            char c, offset_type seqlen )
+        {
+          assert( parent.mismatches > 1 );
+
+          iterator_type base( piter );
+          --parent.mismatches;
+          ++parent.depth;
+          parent.cpos.set_offset( parent.cpos.offset() + 1 );
+          parent.end = ( parent.cpos.offset() == seqlen );
+          for ( char s : { 'A', 'C', 'G', 'T' } ) {
+            if ( s == c ) continue;
+            iterator_type iter( base );
+            if ( !go_down( iter, s ) ) continue;
+            stats_type::inc_total_nof_godowns();
+            this->states.push_back( parent );
+            this->state_iters.push_back( std::move( iter ) );
+          }
+        }
+
+        /**
+         *  @brief  Replace the current node ID of the states by its handle in a view.
+         *
+         *  The loci are added by node IDs, but the traversals step through the graph
+         *  view by node handles from the start (see `node_handle`); e.g. by node ranks
+         *  on a snapshot. The starting loci are kept as node IDs.
+         */
+        template< typename TGraphView >
+          inline void
+        set_node_handles( TGraphView const& graph )
+        {
+          for ( auto& state : this->states ) {
+            state.cpos.set_node_id( node_handle( graph, state.cpos.node_id() ) );
+          }
+        }
     };  /* --- end of template class TraverserBase --- */
 }  /* --- end of namespace psi --- */
 
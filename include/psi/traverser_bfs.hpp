@@ -71,30 +71,59 @@ namespace psi {
           inline void
         run( std::function< void( output_type const& ) > callback )
         {
+          this->template run< std::function< void( output_type const& ) >& >( callback );
+        }
+
+        template< typename TCallback >
+          inline void
+        run( TCallback&& callback )
+        {
+          if ( this->snapshot_ptr != nullptr ) {
+            this->traverse( this->snapshot_ptr->rank_view(), callback );
+          }
+          else {
+            this->traverse( *this->graph_ptr, callback );
+          }
+        }
+
+        /**
+         *  @brief  Run the traversal on the graph or its snapshot.
+         */
+        template< typename TGraphView, typename TCallback >
+          inline void
+        traverse( TGraphView const& graph, TCallback& callback )
+        {
+          this->set_node_handles( graph );
           bool tie;
           do {
+            this->freed.clear();
             std::size_t nofstates = this->states.size();
             tie = true;
             for( std::size_t idx = 0; idx < nofstates; ++idx ) {
-              if ( this->states[ idx ].mismatches == 0 ) continue;
-              filter( this->states[ idx ], callback );
-              advance( this->states[ idx ] );
-              if ( compute( this->states[ idx ] ) ) tie = false;
+              if ( this->states[ idx ].mismatches != 0 ) {
+                filter( idx, callback );
+                advance( graph, idx );
+                if ( compute( graph, idx ) ) tie = false;
+              }
+              if ( this->states[ idx ].mismatches == 0 ) this->freed.push_back( idx );
             }
           } while ( !tie );
 
           this->states.clear();
+          this->state_iters.clear();
         }
 
+        template< typename TCallback >
           inline void
-        filter( typename traits_type::TState& state,
-            std::function< void( output_type const& ) > callback )
+        filter( std::size_t idx, TCallback& callback )
         {
+          auto& state = this->states[ idx ];
           if ( state.mismatches != 0 && state.depth == this->seed_len ) {
             // Cross out the state.
             state.mismatches = 0;
             // Process the seed hit.
-            seqan2::String< TSAValue > saPositions = getOccurrences( state.iter.get_iter_() );
+            seqan2::String< TSAValue > saPositions =
+                getOccurrences( this->state_iters[ idx ].get_iter_() );
             typename seqan2::Size< decltype( saPositions ) >::Type i;
             stats_type::inc_total_seeds_off_paths( length( saPositions ) );
             for ( i = 0; i < length( saPositions ); ++i )
@@ -111,17 +140,19 @@ namespace psi {
           }
         }
 
+        template< typename TGraphView >
           inline bool
-        compute( typename traits_type::TState& state )
+        compute( TGraphView const& graph, std::size_t idx )
         {
+          auto& state = this->states[ idx ];
           if ( state.mismatches == 0 ) return false;
 
-          const auto& sequence = this->graph_ptr->node_sequence( state.cpos.node_id() );
+          const auto& sequence = graph.node_sequence( state.cpos.node_id() );
           assert( state.depth < this->seed_len );
           offset_type end_idx = state.cpos.offset() + this->seed_len - state.depth;
           offset_type i;
           for ( i = state.cpos.offset(); i < end_idx && i < sequence.size(); ++i ) {
-            if ( sequence[i] == 'N' || !go_down( state.iter, sequence[i] ) ) {
+            if ( sequence[i] == 'N' || !go_down( this->state_iters[ idx ], sequence[i] ) ) {
               state.mismatches--;
               break;
             }
@@ -134,31 +165,262 @@ namespace psi {
           return true;
         }
 
+        /**
+         *  @brief  Move the state at `idx` to the next nodes if it is at the end of a node.
+         *
+         *  The state is branched for each extra out-edge into the slot of a dead state
+         *  if there is any; otherwise, it is appended to the states.
+         */
+        template< typename TGraphView >
+          inline void
+        advance( TGraphView const& graph, std::size_t idx )
+        {
+          auto& state = this->states[ idx ];
+          if ( state.mismatches == 0 || !state.end ) return;
+          if ( !graph.has_edges_out( state.cpos.node_id() ) ) {
+            state.mismatches = 0;
+            return;
+          }
+          bool first = true;
+          graph.for_each_edges_out(
+              state.cpos.node_id(),
+              [this, idx, &first]( auto to, linktype_type ) {
+                if ( first ) {
+                  this->states[ idx ].cpos.set_node_id( to );
+                  this->states[ idx ].cpos.set_offset( 0 );
+                  this->states[ idx ].end = false;
+                  first = false;
+                  return true;
+                }
+                std::size_t slot = this->states.size();
+                if ( !this->freed.empty() ) {
+                  slot = this->freed.back();
+                  this->freed.pop_back();
+                  this->states[ slot ] = this->states[ idx ];
+                  this->state_iters[ slot ] = this->state_iters[ idx ];
+                }
+                else {
+                  this->states.push_back( this->states[ idx ] );
+                  this->state_iters.push_back( this->state_iters[ idx ] );
+                }
+                this->states[ slot ].cpos.set_node_id( to );
+                this->states[ slot ].cpos.set_offset( 0 );
+                return true;
+              } );
+        }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        std::vector< std::size_t > freed;  /**< @brief Slots of dead states in a round. */
+    };  /* --- end of template class TraverserBFS --- */
+
+  /**
+   *  @brief  BFS Traverser allowing mismatches (Hamming distance).
+   *
+   *  When a graph character is about to be matched, the states are branched on the
+   *  substitution of that character in the reads index until their mismatch budget
+   *  runs out. The state matching the graph character itself is dropped as soon as
+   *  the reads index cannot be extended by it.
+   */
+  template< class TGraph, typename TIndex, typename TStatsSpec >
+    class TraverserBFS< TGraph, TIndex, ApproxMatching, TStatsSpec >
+    : public TraverserBase< TGraph, TIndex, BFS, ApproxMatching, TStatsSpec >
+    {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef TraverserBase< TGraph, TIndex, BFS, ApproxMatching, TStatsSpec > base_type;
+        typedef typename base_type::graph_type graph_type;
+        typedef typename graph_type::id_type id_type;
+        typedef typename graph_type::offset_type offset_type;
+        typedef typename graph_type::linktype_type linktype_type;
+        typedef typename base_type::output_type output_type;
+        typedef typename base_type::index_type index_type;
+        typedef typename base_type::indexspec_type indexspec_type;
+        typedef typename base_type::stringset_type stringset_type;
+        typedef typename base_type::text_type text_type;
+        typedef typename base_type::records_type records_type;
+        typedef typename base_type::iterspec_type iterspec_type;
+        typedef typename base_type::iterator_type iterator_type;
+        typedef typename base_type::traits_type traits_type;
+        typedef typename base_type::TSAValue TSAValue;
+        typedef typename base_type::stats_type stats_type;
+        /* ====================  LIFECYCLE     ======================================= */
+        TraverserBFS( const graph_type* g, const records_type* r, TIndex* index,
+            unsigned int len )
+          : base_type( g, r, index, len )
+        { }
+
+        TraverserBFS( const graph_type* g, unsigned int len )
+          : base_type( g, len )
+        { }
+
+        TraverserBFS( )
+          : base_type( )
+        { }
+        /* ====================  METHODS       ======================================= */
+          inline void
+        run( std::function< void( output_type const& ) > callback )
+        {
+          this->template run< std::function< void( output_type const& ) >& >( callback );
+        }
+
+        template< typename TCallback >
+          inline void
+        run( TCallback&& callback )
+        {
+          if ( this->snapshot_ptr != nullptr ) {
+            this->traverse( this->snapshot_ptr->rank_view(), callback );
+          }
+          else {
+            this->traverse( *this->graph_ptr, callback );
+          }
+        }
+
+        /**
+         *  @brief  Run the traversal on the graph or its snapshot.
+         */
+        template< typename TGraphView, typename TCallback >
+          inline void
+        traverse( TGraphView const& graph, TCallback& callback )
+        {
+          this->set_node_handles( graph );
+          bool tie;
+          do {
+            this->freed.clear();
+            std::size_t nofstates = this->states.size();
+            for( std::size_t idx = 0; idx < nofstates; ++idx ) {
+              if ( this->states[ idx ].mismatches != 0 ) {
+                filter( idx, callback );
+                advance( graph, idx );
+              }
+              if ( this->states[ idx ].mismatches == 0 ) this->freed.push_back( idx );
+            }
+            tie = !compute( graph, nofstates );
+          } while ( !tie );
+
+          this->states.clear();
+          this->state_iters.clear();
+        }
+
+        template< typename TCallback >
+          inline void
+        filter( std::size_t idx, TCallback& callback )
+        {
+          auto& state = this->states[ idx ];
+          if ( state.mismatches != 0 && state.depth == this->seed_len ) {
+            offset_type nofmismatches = base_type::max_mismatches + 1 - state.mismatches;
+            // Cross out the state.
+            state.mismatches = 0;
+            // Process the seed hit.
+            seqan2::String< TSAValue > saPositions =
+                getOccurrences( this->state_iters[ idx ].get_iter_() );
+            typename seqan2::Size< decltype( saPositions ) >::Type i;
+            stats_type::inc_total_seeds_off_paths( length( saPositions ) );
+            for ( i = 0; i < length( saPositions ); ++i )
+            {
+              output_type hit;
+              hit.node_id = state.spos.node_id();
+              hit.node_offset = state.spos.offset();
+              hit.read_id = position_to_id( *(this->reads), saPositions[i].i1 );  // Read ID.
+              hit.read_offset = position_to_offset( *(this->reads), saPositions[i] );  // Position in the read.
+              hit.match_len = this->seed_len;
+              hit.gocc = length( saPositions );
+              hit.mismatches = nofmismatches;
+              callback( hit );
+            }
+          }
+        }
+
+        /**
+         *  @brief  Compute the first `nofstates` states.
+         *
+         *  The states branched on substitutions are appended to `states`; they are
+         *  computed in the next round.
+         *
+         *  @return `true` if any of the states is computed.
+         */
+        template< typename TGraphView >
+          inline bool
+        compute( TGraphView const& graph, std::size_t nofstates )
+        {
+          bool computed = false;
+          for ( std::size_t idx = 0; idx < nofstates; ++idx ) {
+            if ( this->states[ idx ].mismatches == 0 ) continue;
+            computed = true;
+
+            const auto& sequence =
+                graph.node_sequence( this->states[ idx ].cpos.node_id() );
+            assert( this->states[ idx ].depth < this->seed_len );
+            offset_type end_idx =
+                this->states[ idx ].cpos.offset() + this->seed_len - this->states[ idx ].depth;
+            for ( offset_type i = this->states[ idx ].cpos.offset();
+                  i < end_idx && i < sequence.size(); ++i ) {
+              if ( this->states[ idx ].mismatches > 1 ) {
+                this->add_substitutions( this->states[ idx ], this->state_iters[ idx ],
+                                         sequence[i], sequence.size() );
+              }
+              // The pools might be reallocated by adding substitutions.
+              auto& state = this->states[ idx ];
+              if ( sequence[i] == 'N' || !go_down( this->state_iters[ idx ], sequence[i] ) ) {
+                state.mismatches = 0;
+                break;
+              }
+              ++state.depth;
+              stats_type::inc_total_nof_godowns();
+              state.cpos.set_offset( i + 1 );
+            }
+
+            auto& state = this->states[ idx ];
+            if ( state.cpos.offset() == sequence.size() ) state.end = true;
+          }
+          return computed;
+        }
+
+        /**
+         *  @brief  Move the state at `idx` to the next nodes if it is at the end of a node.
+         *
+         *  The state is branched for each extra out-edge into the slot of a dead state
+         *  if there is any; otherwise, it is appended to the states.
+         */
+        template< typename TGraphView >
           inline void
-        advance( typename traits_type::TState& state )
+        advance( TGraphView const& graph, std::size_t idx )
         {
+          auto& state = this->states[ idx ];
           if ( state.mismatches == 0 || !state.end ) return;
-          if ( !this->graph_ptr->has_edges_out( state.cpos.node_id() ) ) {
+          if ( !graph.has_edges_out( state.cpos.node_id() ) ) {
             state.mismatches = 0;
             return;
           }
           bool first = true;
-          this->graph_ptr->for_each_edges_out(
+          graph.for_each_edges_out(
               state.cpos.node_id(),
-              [this, &state, &first]( id_type to, linktype_type ) {
+              [this, idx, &first]( auto to, linktype_type ) {
                 if ( first ) {
-                  state.cpos.set_node_id( to );
-                  state.cpos.set_offset( 0 );
-                  state.end = false;
+                  this->states[ idx ].cpos.set_node_id( to );
+                  this->states[ idx ].cpos.set_offset( 0 );
+                  this->states[ idx ].end = false;
                   first = false;
                   return true;
                 }
-                this->states.push_back( state );
-                this->states.back().cpos.set_node_id( to );
-                this->states.back().cpos.set_offset( 0 );
+                std::size_t slot = this->states.size();
+                if ( !this->freed.empty() ) {
+                  slot = this->freed.back();
+                  this->freed.pop_back();
+                  this->states[ slot ] = this->states[ idx ];
+                  this->state_iters[ slot ] = this->state_iters[ idx ];
+                }
+                else {
+                  this->states.push_back( this->states[ idx ] );
+                  this->state_iters.push_back( this->state_iters[ idx ] );
+                }
+                this->states[ slot ].cpos.set_node_id( to );
+                this->states[ slot ].cpos.set_offset( 0 );
                 return true;
               } );
         }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        std::vector< std::size_t > freed;  /**< @brief Slots of dead states in a round. */
     };  /* --- end of template class TraverserBFS --- */
 }  /* --- end of namespace psi --- */
 
@@ -57,36 +57,60 @@ namespace psi {
         /* ====================  LIFECYCLE     ======================================= */
         TraverserDFS( const graph_type* g, const records_type* r, TIndex* index,
             unsigned int len )
-          : base_type( g, r, index, len ), cstate( index, 0, 0, 0, 0 )
+          : base_type( g, r, index, len ), cstate( 0, 0, 0, 0 ), citer( *index )
         { }
 
         TraverserDFS( const graph_type* g, unsigned int len )
-          : base_type( g, len ), cstate( nullptr, 0, 0, 0, 0 )
+          : base_type( g, len ), cstate( 0, 0, 0, 0 ), citer( *this->reads_index )
         { }
 
         TraverserDFS( )
-          : base_type( ), cstate( nullptr, 0, 0, 0, 0 )
+          : base_type( ), cstate( 0, 0, 0, 0 ), citer( *this->reads_index )
         { }
         /* ====================  METHODS       ======================================= */
           inline void
         run( std::function< void( output_type const& ) > callback )
         {
+          this->template run< std::function< void( output_type const& ) >& >( callback );
+        }
+
+        template< typename TCallback >
+          inline void
+        run( TCallback&& callback )
+        {
+          if ( this->snapshot_ptr != nullptr ) {
+            this->traverse( this->snapshot_ptr->rank_view(), callback );
+          }
+          else {
+            this->traverse( *this->graph_ptr, callback );
+          }
+        }
+
+        /**
+         *  @brief  Run the traversal on the graph or its snapshot.
+         */
+        template< typename TGraphView, typename TCallback >
+          inline void
+        traverse( TGraphView const& graph, TCallback& callback )
+        {
+          this->set_node_handles( graph );
           while( ! this->states.empty() )
           {
             filter( callback );
-            advance( );
-            compute( );
+            advance( graph );
+            compute( graph );
           }
         }
 
+        template< typename TCallback >
           inline void
-        filter( std::function< void( output_type const& ) > callback )
+        filter( TCallback& callback )
         {
           if ( cstate.mismatches != 0 && cstate.depth == this->seed_len ) {
             // Cross out the cstate.
             cstate.mismatches = 0;
             // Process the seed hit.
-            seqan2::String< TSAValue > saPositions = getOccurrences( cstate.iter.get_iter_() );
+            seqan2::String< TSAValue > saPositions = getOccurrences( citer.get_iter_() );
             typename seqan2::Size< decltype( saPositions ) >::Type i;
             stats_type::inc_total_seeds_off_paths( length( saPositions ) );
             for ( i = 0; i < length( saPositions ); ++i )
@@ -103,17 +127,18 @@ namespace psi {
           }
         }
 
+        template< typename TGraphView >
           inline bool
-        compute( )
+        compute( TGraphView const& graph )
         {
           if ( cstate.mismatches == 0 ) return false;
 
-          const auto& sequence = this->graph_ptr->node_sequence( cstate.cpos.node_id() );
+          const auto& sequence = graph.node_sequence( cstate.cpos.node_id() );
           assert( cstate.depth < this->seed_len );
           offset_type end_idx = cstate.cpos.offset() + this->seed_len - cstate.depth;
           offset_type i;
           for ( i = cstate.cpos.offset(); i < end_idx && i < sequence.size(); ++i ) {
-            if ( sequence[i] == 'N' || !go_down( cstate.iter, sequence[i] ) ) {
+            if ( sequence[i] == 'N' || !go_down( citer, sequence[i] ) ) {
               cstate.mismatches--;
               break;
             }
@@ -126,26 +151,202 @@ namespace psi {
           return true;
         }
 
+        template< typename TGraphView >
+          inline void
+        advance( TGraphView const& graph )
+        {
+          if ( cstate.mismatches == 0 && ( !this->states.empty() ) )
+          {
+            this->cstate = this->states.back();
+            this->citer = std::move( this->state_iters.back() );
+            this->states.pop_back();
+            this->state_iters.pop_back();
+            return;
+          }
+
+          if ( cstate.mismatches == 0 || !cstate.end ) return;
+
+          if ( !graph.has_edges_out( this->cstate.cpos.node_id() ) ) {
+            cstate.mismatches = 0;
+            return;
+          }
+          bool first = true;
+          graph.for_each_edges_out(
+              this->cstate.cpos.node_id(),
+              [this, &first]( auto to, linktype_type ) {
+                if ( first ) {
+                  this->cstate.cpos.set_node_id( to );
+                  this->cstate.cpos.set_offset( 0 );
+                  this->cstate.end = false;
+                  first = false;
+                  return true;
+                }
+                this->states.emplace_back( this->cstate );
+                this->state_iters.push_back( this->citer );
+                this->states.back().cpos.set_node_id( to );
+                this->states.back().cpos.set_offset( 0 );
+                return true;
+              } );
+        }
+      private:
+        /* ====================  DATA MEMBERS  ======================================= */
+        typename traits_type::TState cstate;
+        iterator_type citer;  /**< @brief Reads index iterator of the current state. */
+    };  /* --- end of template class TraverserDFS --- */
+
+  /**
+   *  @brief  DFS Traverser allowing mismatches (Hamming distance).
+   *
+   *  The states branched on the substitution of a graph character in the reads index
+   *  are pushed to the stack and are visited after the current one.
+   */
+  template< class TGraph, typename TIndex, typename TStatsSpec >
+    class TraverserDFS< TGraph, TIndex, ApproxMatching, TStatsSpec >
+    : public TraverserBase< TGraph, TIndex, DFS, ApproxMatching, TStatsSpec >
+    {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef TraverserBase< TGraph, TIndex, DFS, ApproxMatching, TStatsSpec > base_type;
+        typedef typename base_type::graph_type graph_type;
+        typedef typename graph_type::id_type id_type;
+        typedef typename graph_type::offset_type offset_type;
+        typedef typename graph_type::linktype_type linktype_type;
+        typedef typename base_type::output_type output_type;
+        typedef typename base_type::index_type index_type;
+        typedef typename base_type::indexspec_type indexspec_type;
+        typedef typename base_type::stringset_type stringset_type;
+        typedef typename base_type::text_type text_type;
+        typedef typename base_type::records_type records_type;
+        typedef typename base_type::iterspec_type iterspec_type;
+        typedef typename base_type::iterator_type iterator_type;
+        typedef typename base_type::traits_type traits_type;
+        typedef typename base_type::TSAValue TSAValue;
+        typedef typename base_type::stats_type stats_type;
+        /* ====================  LIFECYCLE     ======================================= */
+        TraverserDFS( const graph_type* g, const records_type* r, TIndex* index,
+            unsigned int len )
+          : base_type( g, r, index, len ), cstate( 0, 0, 0, 0 ), citer( *index )
+        { }
+
+        TraverserDFS( const graph_type* g, unsigned int len )
+          : base_type( g, len ), cstate( 0, 0, 0, 0 ), citer( *this->reads_index )
+        { }
+
+        TraverserDFS( )
+          : base_type( ), cstate( 0, 0, 0, 0 ), citer( *this->reads_index )
+        { }
+        /* ====================  METHODS       ======================================= */
+          inline void
+        run( std::function< void( output_type const& ) > callback )
+        {
+          this->template run< std::function< void( output_type const& ) >& >( callback );
+        }
+
+        template< typename TCallback >
+          inline void
+        run( TCallback&& callback )
+        {
+          if ( this->snapshot_ptr != nullptr ) {
+            this->traverse( this->snapshot_ptr->rank_view(), callback );
+          }
+          else {
+            this->traverse( *this->graph_ptr, callback );
+          }
+        }
+
+        /**
+         *  @brief  Run the traversal on the graph or its snapshot.
+         */
+        template< typename TGraphView, typename TCallback >
+          inline void
+        traverse( TGraphView const& graph, TCallback& callback )
+        {
+          this->set_node_handles( graph );
+          while ( true ) {
+            filter( callback );
+            advance( graph );
+            if ( cstate.mismatches == 0 && this->states.empty() ) break;
+            compute( graph );
+          }
+        }
+
+        template< typename TCallback >
+          inline void
+        filter( TCallback& callback )
+        {
+          if ( cstate.mismatches != 0 && cstate.depth == this->seed_len ) {
+            offset_type nofmismatches = base_type::max_mismatches + 1 - cstate.mismatches;
+            // Cross out the cstate.
+            cstate.mismatches = 0;
+            // Process the seed hit.
+            seqan2::String< TSAValue > saPositions = getOccurrences( citer.get_iter_() );
+            typename seqan2::Size< decltype( saPositions ) >::Type i;
+            stats_type::inc_total_seeds_off_paths( length( saPositions ) );
+            for ( i = 0; i < length( saPositions ); ++i )
+            {
+              output_type hit;
+              hit.node_id = cstate.spos.node_id();
+              hit.node_offset = cstate.spos.offset();
+              hit.read_id = position_to_id( *(this->reads), saPositions[i].i1 );  // Read ID.
+              hit.read_offset = position_to_offset( *(this->reads), saPositions[i] );  // Position in the read.
+              hit.match_len = this->seed_len;
+              hit.gocc = length( saPositions );
+              hit.mismatches = nofmismatches;
+              callback( hit );
+            }
+          }
+        }
+
+        template< typename TGraphView >
+          inline bool
+        compute( TGraphView const& graph )
+        {
+          if ( cstate.mismatches == 0 ) return false;
+          // A state branched on a substitution might be already a seed hit.
+          if ( cstate.depth == this->seed_len ) return true;
+
+          const auto& sequence = graph.node_sequence( cstate.cpos.node_id() );
+          offset_type end_idx = cstate.cpos.offset() + this->seed_len - cstate.depth;
+          for ( offset_type i = cstate.cpos.offset(); i < end_idx && i < sequence.size(); ++i ) {
+            if ( cstate.mismatches > 1 ) {
+              this->add_substitutions( cstate, citer, sequence[i], sequence.size() );
+            }
+            if ( sequence[i] == 'N' || !go_down( citer, sequence[i] ) ) {
+              cstate.mismatches = 0;
+              return true;
+            }
+            ++cstate.depth;
+            stats_type::inc_total_nof_godowns();
+            cstate.cpos.set_offset( i + 1 );
+          }
+
+          if ( cstate.cpos.offset() == sequence.size() ) cstate.end = true;
+          return true;
+        }
+
+        template< typename TGraphView >
           inline void
-        advance( )
+        advance( TGraphView const& graph )
         {
           if ( cstate.mismatches == 0 && ( !this->states.empty() ) )
           {
             this->cstate = this->states.back();
+            this->citer = std::move( this->state_iters.back() );
             this->states.pop_back();
+            this->state_iters.pop_back();
             return;
           }
 
           if ( cstate.mismatches == 0 || !cstate.end ) return;
 
-          if ( !this->graph_ptr->has_edges_out( this->cstate.cpos.node_id() ) ) {
+          if ( !graph.has_edges_out( this->cstate.cpos.node_id() ) ) {
             cstate.mismatches = 0;
             return;
           }
           bool first = true;
-          this->graph_ptr->for_each_edges_out(
+          graph.for_each_edges_out(
               this->cstate.cpos.node_id(),
-              [this, &first]( id_type to, linktype_type ) {
+              [this, &first]( auto to, linktype_type ) {
                 if ( first ) {
                   this->cstate.cpos.set_node_id( to );
                   this->cstate.cpos.set_offset( 0 );
@@ -154,6 +355,7 @@ namespace psi {
                   return true;
                 }
                 this->states.emplace_back( this->cstate );
+                this->state_iters.push_back( this->citer );
                 this->states.back().cpos.set_node_id( to );
                 this->states.back().cpos.set_offset( 0 );
                 return true;
@@ -162,6 +364,450 @@ namespace psi {
       private:
         /* ====================  DATA MEMBERS  ======================================= */
         typename traits_type::TState cstate;
+        iterator_type citer;  /**< @brief Reads index iterator of the current state. */
+    };  /* --- end of template class TraverserDFS --- */
+
+  /**
+   *  @brief  DFS Traverser finding seeds within an edit distance.
+   *
+   *  The reads are the candidate patterns which are aligned against the graph walks
+   *  starting from each locus using Myers' bit-parallel algorithm. The states are
+   *  extended along the graph edges as long as their last alignment column has a row
+   *  in the error budget. For each starting locus and read, the best alignment over
+   *  all walks is reported where `mismatches` is its edit distance and `match_len` is
+   *  the length of the aligned walk. Since each state aligns one pattern, it is only
+   *  a DFS traverser to keep the number of live states bounded.
+   *
+   *  Not all reads are aligned at each locus: by the pigeonhole principle, a pattern
+   *  within `k` edits has at least one of its `k+1` disjoint pieces of length
+   *  `q = minlen / (k+1)` matched exactly at most `k` characters away from its
+   *  offset in the pattern. So, the pieces are indexed when the reads are set, and
+   *  only the reads having a piece found in the walks around the locus are aligned.
+   *  The reads whose pieces cannot be matched (e.g. having 'N') are always aligned.
+   */
+  template< class TGraph, typename TIndex, typename TStatsSpec >
+    class TraverserDFS< TGraph, TIndex, EditMatching, TStatsSpec >
+    : public TraverserBase< TGraph, TIndex, DFS, EditMatching, TStatsSpec >
+    {
+      public:
+        /* ====================  TYPEDEFS      ======================================= */
+        typedef TraverserBase< TGraph, TIndex, DFS, EditMatching, TStatsSpec > base_type;
+        typedef typename base_type::graph_type graph_type;
+        typedef typename graph_type::id_type id_type;
+        typedef typename graph_type::offset_type offset_type;
+        typedef typename graph_type::linktype_type linktype_type;
+        typedef typename base_type::output_type output_type;
+        typedef typename base_type::index_type index_type;
+        typedef typename base_type::indexspec_type indexspec_type;
+        typedef typename base_type::stringset_type stringset_type;
+        typedef typename base_type::text_type text_type;
+        typedef typename base_type::records_type records_type;
+        typedef typename base_type::iterspec_type iterspec_type;
+        typedef typename base_type::iterator_type iterator_type;
+        typedef typename base_type::traits_type traits_type;
+        typedef typename base_type::TSAValue TSAValue;
+        typedef typename base_type::stats_type stats_type;
+        typedef std::array< std::uint64_t, 4 > peq_type;
+        /**
+         *  @brief  A piece of a pattern used for filtering the candidate patterns.
+         */
+        struct Piece {
+          std::uint64_t code;          /**< @brief 2-bit encoded piece. */
+          std::size_t pattern;         /**< @brief Index of the pattern. */
+          unsigned int start;          /**< @brief Offset of the piece in the pattern. */
+        };
+        /**
+         *  @brief  A graph walk enumerating the q-grams around a locus.
+         */
+        struct Walk {
+          Position<> pos;              /**< @brief Current locus (by node handle). */
+          std::uint64_t code;          /**< @brief 2-bit encoded last q-gram. */
+          unsigned int depth;          /**< @brief Length of the walk so far. */
+          unsigned int valid;          /**< @brief Length of the last run of ACGTs. */
+        };
+        typedef Piece piece_type;
+        typedef Walk walk_type;
+        /* ====================  CONSTANTS     ======================================= */
+        constexpr static const unsigned int MAX_PIECE_LEN = 32;
+        /* ====================  LIFECYCLE     ======================================= */
+        TraverserDFS( const graph_type* g, const records_type* r, TIndex* index,
+            unsigned int len )
+          : base_type( g, r, index, len ), cstate( Position<>(), 0, 0, 0 ), qlen( 0 ),
+          stamp( 0 )
+        {
+          this->set_reads( r );
+        }
+
+        TraverserDFS( const graph_type* g, unsigned int len )
+          : base_type( g, len ), cstate( Position<>(), 0, 0, 0 ), qlen( 0 ), stamp( 0 )
+        { }
+
+        TraverserDFS( )
+          : base_type( ), cstate( Position<>(), 0, 0, 0 ), qlen( 0 ), stamp( 0 )
+        { }
+        /* ====================  MUTATORS      ======================================= */
+        /**
+         *  @brief  Set the reads, compute their pattern match vectors and index their
+         *          pieces.
+         */
+          inline void
+        set_reads( const records_type* value )
+        {
+          base_type::set_reads( value );
+          this->peqs.clear();
+          this->plens.clear();
+          this->pieces.clear();
+          this->unfiltered.clear();
+          this->marks.clear();
+          this->qlen = 0;
+          if ( value == nullptr ) return;
+
+          unsigned int minlen = traits_type::max_pattern_len;
+          for ( std::size_t i = 0; i < length( value->str ); ++i ) {
+            const auto& read = value->str[ i ];
+            if ( length( read ) == 0 || length( read ) > traits_type::max_pattern_len ) {
+              throw std::runtime_error( "read length should be in [1, " +
+                  std::to_string( traits_type::max_pattern_len ) + "]" );
+            }
+            peq_type peq = { 0, 0, 0, 0 };
+            for ( std::size_t j = 0; j < length( read ); ++j ) {
+              auto ord = seqan2::ordValue( seqan2::Dna5( read[ j ] ) );
+              if ( ord < 4 ) peq[ ord ] |= std::uint64_t( 1 ) << j;
+            }
+            this->peqs.push_back( peq );
+            this->plens.push_back( length( read ) );
+            minlen = std::min< unsigned int >( minlen, length( read ) );
+          }
+          this->marks.resize( this->peqs.size(), 0 );
+
+          this->qlen = std::min< unsigned int >( minlen / ( base_type::max_mismatches + 1 ),
+                                                MAX_PIECE_LEN );
+          for ( std::size_t i = 0; i < length( value->str ); ++i ) {
+            if ( this->qlen == 0 || !this->add_pieces( value->str[ i ], i ) ) {
+              this->unfiltered.push_back( i );
+            }
+          }
+          std::sort( this->pieces.begin(), this->pieces.end(),
+                     []( piece_type const& a, piece_type const& b ) {
+                       return a.code < b.code;
+                     } );
+        }
+        /* ====================  METHODS       ======================================= */
+          inline void
+        add_locus( Position<> p )
+        {
+          this->loci.push_back( std::move( p ) );
+        }
+
+          inline void
+        add_locus( id_type id, offset_type offset )
+        {
+          Position<> p;
+          p.set_node_id( id );
+          p.set_offset( offset );
+          this->add_locus( std::move( p ) );
+        }
+
+          inline void
+        run( std::function< void( output_type const& ) > callback )
+        {
+          this->template run< std::function< void( output_type const& ) >& >( callback );
+        }
+
+        template< typename TCallback >
+          inline void
+        run( TCallback&& callback )
+        {
+          if ( this->snapshot_ptr != nullptr ) {
+            this->traverse( this->snapshot_ptr->rank_view(), callback );
+          }
+          else {
+            this->traverse( *this->graph_ptr, callback );
+          }
+        }
+
+        /**
+         *  @brief  Run the traversal on the graph or its snapshot.
+         */
+        template< typename TGraphView, typename TCallback >
+          inline void
+        traverse( TGraphView const& graph, TCallback& callback )
+        {
+          for ( auto const& locus : this->loci ) {
+            Position<> start( locus );
+            start.set_node_id( node_handle( graph, locus.node_id() ) );
+            this->add_candidates( graph, locus, start );
+          }
+          this->loci.clear();
+
+          while ( true ) {
+            advance( graph );
+            if ( cstate.mismatches == 0 && this->states.empty() ) break;
+            compute( graph );
+          }
+
+          for ( auto const& hit : this->hits ) {
+            if ( hit.mismatches > base_type::max_mismatches ) continue;
+            stats_type::inc_total_seeds_off_paths();
+            callback( hit );
+          }
+          this->hits.clear();
+          this->patterns.clear();
+        }
+
+        template< typename TGraphView >
+          inline bool
+        compute( TGraphView const& graph )
+        {
+          if ( cstate.mismatches == 0 ) return false;
+
+          auto& hit = this->hits[ cstate.hit ];
+          auto pattern = this->patterns[ cstate.hit ];
+          const peq_type& peq = this->peqs[ pattern ];
+          unsigned int plen = this->plens[ pattern ];
+          std::size_t maxlen = plen + base_type::max_mismatches;
+          const auto& sequence = graph.node_sequence( cstate.cpos.node_id() );
+          offset_type i;
+          for ( i = cstate.cpos.offset(); i < sequence.size() && cstate.depth < maxlen; ++i ) {
+            bool alive = extend( cstate, peq, plen, sequence[i] );
+            if ( cstate.score < hit.mismatches ) {
+              hit.mismatches = cstate.score;
+              hit.match_len = cstate.depth;
+            }
+            if ( !alive ) return true;
+          }
+
+          cstate.cpos.set_offset( i );
+          if ( cstate.depth == maxlen ) cstate.mismatches = 0;
+          else if ( i == sequence.size() ) cstate.end = true;
+          return true;
+        }
+
+        template< typename TGraphView >
+          inline void
+        advance( TGraphView const& graph )
+        {
+          if ( cstate.mismatches == 0 && ( !this->states.empty() ) )
+          {
+            this->cstate = this->states.back();
+            this->states.pop_back();
+            return;
+          }
+
+          if ( cstate.mismatches == 0 || !cstate.end ) return;
+
+          if ( !graph.has_edges_out( this->cstate.cpos.node_id() ) ) {
+            cstate.mismatches = 0;
+            return;
+          }
+          bool first = true;
+          graph.for_each_edges_out(
+              this->cstate.cpos.node_id(),
+              [this, &first]( auto to, linktype_type ) {
+                if ( first ) {
+                  this->cstate.cpos.set_node_id( to );
+                  this->cstate.cpos.set_offset( 0 );
+                  this->cstate.end = false;
+                  first = false;
+                  return true;
+                }
+                this->states.emplace_back( this->cstate );
+                this->states.back().cpos.set_node_id( to );
+                this->states.back().cpos.set_offset( 0 );
+                this->states.back().end = false;
+                return true;
+              } );
+        }
+      private:
+        /* ====================  METHODS       ======================================= */
+        /**
+         *  @brief  Index the pieces of a pattern.
+         *
+         *  @return `false` if a piece contains a non-ACGT character; i.e. the pattern
+         *  cannot be filtered by its pieces.
+         */
+        template< typename TText >
+          inline bool
+        add_pieces( TText const& read, std::size_t pattern )
+        {
+          auto nofpieces = this->pieces.size();
+          for ( unsigned int j = 0; j <= base_type::max_mismatches; ++j ) {
+            piece_type piece = { 0, pattern, j * this->qlen };
+            for ( unsigned int l = piece.start; l < piece.start + this->qlen; ++l ) {
+              auto ord = seqan2::ordValue( seqan2::Dna5( read[ l ] ) );
+              if ( ord > 3 ) {
+                this->pieces.resize( nofpieces );
+                return false;
+              }
+              piece.code = ( piece.code << 2 ) | ord;
+            }
+            this->pieces.push_back( piece );
+          }
+          return true;
+        }
+
+        /**
+         *  @brief  Add a state for each candidate pattern at a starting locus.
+         *
+         *  The q-grams of the walks starting from the locus are looked up in the
+         *  pieces; a pattern is a candidate if a piece is found in the band of `k`
+         *  characters around its offset in the pattern. The `start` is the locus by
+         *  node handle in the graph view.
+         */
+        template< typename TGraphView >
+          inline void
+        add_candidates( TGraphView const& graph, Position<> const& locus,
+            Position<> const& start )
+        {
+          ++this->stamp;
+          this->candidates.clear();
+          if ( this->qlen != 0 && !this->pieces.empty() ) {
+            const std::uint64_t qmask = ( this->qlen < MAX_PIECE_LEN ?
+                                          ( std::uint64_t( 1 ) << ( 2 * this->qlen ) ) - 1 :
+                                          ~std::uint64_t( 0 ) );
+            const unsigned int maxdepth =
+                ( base_type::max_mismatches + 1 ) * ( this->qlen + 1 ) - 1;
+            this->walks.clear();
+            this->walks.push_back( { start, 0, 0, 0 } );
+            while ( !this->walks.empty() ) {
+              walk_type walk = this->walks.back();
+              this->walks.pop_back();
+              const auto& sequence = graph.node_sequence( walk.pos.node_id() );
+              offset_type i;
+              for ( i = walk.pos.offset(); i < sequence.size() && walk.depth < maxdepth; ++i ) {
+                auto ord = seqan2::ordValue( seqan2::Dna5( sequence[ i ] ) );
+                walk.code = ( ( walk.code << 2 ) | ( ord & 3 ) ) & qmask;
+                walk.valid = ( ord < 4 ? walk.valid + 1 : 0 );
+                ++walk.depth;
+                if ( walk.valid >= this->qlen ) this->mark( walk.code, walk.depth - this->qlen );
+              }
+              if ( i < sequence.size() || walk.depth == maxdepth ) continue;
+              graph.for_each_edges_out(
+                  walk.pos.node_id(),
+                  [this, &walk]( auto to, linktype_type ) {
+                    this->walks.push_back( walk );
+                    this->walks.back().pos.set_node_id( to );
+                    this->walks.back().pos.set_offset( 0 );
+                    return true;
+                  } );
+            }
+          }
+
+          for ( auto pattern : this->unfiltered ) this->add_state( locus, start, pattern );
+          for ( auto pattern : this->candidates ) this->add_state( locus, start, pattern );
+        }
+
+        /**
+         *  @brief  Mark the patterns having a piece equal to the q-gram at `offset`.
+         */
+          inline void
+        mark( std::uint64_t code, unsigned int offset )
+        {
+          const auto k = base_type::max_mismatches;
+          auto it = std::lower_bound( this->pieces.begin(), this->pieces.end(), code,
+                                      []( piece_type const& p, std::uint64_t c ) {
+                                        return p.code < c;
+                                      } );
+          for ( ; it != this->pieces.end() && it->code == code; ++it ) {
+            if ( offset > it->start + k || it->start > offset + k ) continue;
+            if ( this->marks[ it->pattern ] == this->stamp ) continue;
+            this->marks[ it->pattern ] = this->stamp;
+            this->candidates.push_back( it->pattern );
+          }
+        }
+
+          inline void
+        add_state( Position<> const& locus, Position<> const& start, std::size_t pattern )
+        {
+          typename records_type::TStringSetPosition pos( pattern, 0 );
+          output_type hit;
+          hit.node_id = locus.node_id();
+          hit.node_offset = locus.offset();
+          hit.read_id = position_to_id( *this->reads, pattern );
+          hit.read_offset = position_to_offset( *this->reads, pos );
+          hit.match_len = 0;
+          hit.gocc = 1;
+          hit.mismatches = base_type::max_mismatches + 1;
+          this->hits.push_back( hit );
+          this->patterns.push_back( pattern );
+          this->states.emplace_back( locus, this->hits.size() - 1, this->plens[ pattern ],
+              base_type::max_mismatches + 1 );
+          this->states.back().cpos = start;
+        }
+
+        /**
+         *  @brief  Extend the alignment of a state by one graph character.
+         *
+         *  Compute the next column by Myers' algorithm where the first row increases
+         *  by one in each column; i.e. the alignment starts at the starting locus.
+         *  The value of the `active` row is updated by its horizontal delta. Since the
+         *  values are non-decreasing along the diagonals, the active row moves down by
+         *  at most one row per column; and it moves up while its value is out of the
+         *  error budget.
+         *
+         *  @return `false` if no row of the new column is in the error budget.
+         */
+          static inline bool
+        extend( typename traits_type::TState& state, const peq_type& peq,
+            unsigned int plen, char c )
+        {
+          const unsigned int k = traits_type::max_mismatches;
+          const std::uint64_t mask = ( plen < 64 ? ( std::uint64_t( 1 ) << plen ) - 1
+                                                 : ~std::uint64_t( 0 ) );
+          const std::uint64_t last = std::uint64_t( 1 ) << ( plen - 1 );
+          auto ord = seqan2::ordValue( seqan2::Dna5( c ) );
+          std::uint64_t eq = ( ord < 4 ? peq[ ord ] : 0 );
+          std::uint64_t xv = eq | state.mv;
+          std::uint64_t xh = ( ( ( eq & state.pv ) + state.pv ) ^ state.pv ) | eq;
+          std::uint64_t ph = state.mv | ~( xh | state.pv );
+          std::uint64_t mh = state.pv & xh;
+          if ( ph & last ) ++state.score;
+          else if ( mh & last ) --state.score;
+
+          unsigned int row = state.active;
+          unsigned int value = k + 1 - state.mismatches;
+          if ( row == 0 ) ++value;
+          else value = value + ( ( ph >> ( row - 1 ) ) & 1 ) - ( ( mh >> ( row - 1 ) ) & 1 );
+
+          ph = ( ph << 1 ) | 1;
+          mh <<= 1;
+          state.pv = ( mh | ~( xv | ph ) ) & mask;
+          state.mv = ( ph & xv ) & mask;
+          ++state.depth;
+
+          if ( row < plen ) {
+            unsigned int next = value + ( ( state.pv >> row ) & 1 ) - ( ( state.mv >> row ) & 1 );
+            if ( next <= k ) {
+              ++row;
+              value = next;
+            }
+          }
+          while ( value > k ) {
+            if ( row == 0 ) {
+              state.mismatches = 0;
+              return false;
+            }
+            --row;
+            value = value - ( ( state.pv >> row ) & 1 ) + ( ( state.mv >> row ) & 1 );
+          }
+          state.active = row;
+          state.mismatches = k + 1 - value;
+          return true;
+        }
+        /* ====================  DATA MEMBERS  ======================================= */
+        typename traits_type::TState cstate;
+        std::vector< peq_type > peqs;          /**< @brief Pattern match vectors of the reads. */
+        std::vector< unsigned int > plens;     /**< @brief Pattern lengths. */
+        unsigned int qlen;                     /**< @brief Length of the pieces. */
+        std::vector< piece_type > pieces;      /**< @brief Pieces of the patterns sorted by code. */
+        std::vector< std::size_t > unfiltered; /**< @brief Patterns aligned at all loci. */
+        std::vector< std::size_t > marks;      /**< @brief Last locus a pattern is marked at. */
+        std::size_t stamp;                     /**< @brief Current locus stamp. */
+        std::vector< std::size_t > candidates; /**< @brief Candidate patterns of the locus. */
+        std::vector< walk_type > walks;        /**< @brief Walk stack of the filter. */
+        std::vector< Position<> > loci;        /**< @brief Loci to be traversed in the next run. */
+        std::vector< output_type > hits;       /**< @brief Best hits of the current run. */
+        std::vector< std::size_t > patterns;   /**< @brief Pattern index of each hit. */
     };  /* --- end of template class TraverserDFS --- */
 }  /* --- end of namespace psi --- */
 
@@ -20,11 +20,15 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <iostream>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <vector>
+#include <deque>
 #include <unordered_map>
 #include <set>
 #include <memory>
@@ -34,6 +38,12 @@
 #include <cctype>
 #include <locale>
 #include <random>
+#include <streambuf>
+#include <type_traits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <seqan/basic.h>
 #include <sdsl/enc_vector.hpp>
@@ -399,6 +409,34 @@ namespace psi {
     }  /* -----  end of function bv_icopy  ----- */
 
 
+  /**
+   *  @brief  Get the size of available physical memory in bytes.
+   *
+   *  It is `MemAvailable` in `/proc/meminfo` on Linux which, unlike the free memory,
+   *  includes the reclaimable page cache. Otherwise, it falls back to the number of
+   *  available physical pages reported by `sysconf`.
+   *
+   *  @return The available memory or 0 if it cannot be determined.
+   */
+    inline std::size_t
+  get_available_memory( )
+  {
+    std::ifstream meminfo( "/proc/meminfo" );
+    std::string key;
+    std::size_t value;
+    std::string unit;
+    while ( meminfo >> key >> value ) {
+      std::getline( meminfo, unit );
+      if ( key == "MemAvailable:" ) return value * 1024;  // reported in kB
+    }
+
+    long pages = ::sysconf( _SC_AVPHYS_PAGES );
+    long page_size = ::sysconf( _SC_PAGE_SIZE );
+    if ( pages < 0 || page_size < 0 ) return 0;
+    return static_cast< std::size_t >( pages ) * static_cast< std::size_t >( page_size );
+  }  /* -----  end of function get_available_memory  ----- */
+
+
   /**
    *  @brief  Check if the given file exists and is readable.
    *
@@ -510,6 +548,19 @@ namespace psi {
 
   typedef uint64_t DefaultContainerSize;
 
+  /**
+   *  @brief  Whether the objects of a type are (de)serialised by the generic bitwise
+   *          overloads of `serialize`/`deserialize`.
+   *
+   *  A vector of such objects is deserialised by one bulk read. It holds for the
+   *  arithmetic types; a POD type which has no custom overload can opt in by a
+   *  specialisation (e.g. `PositionBase`).
+   */
+  template< typename T >
+    class is_bitwise_serializable
+      : public std::integral_constant< bool, std::is_arithmetic< T >::value > {
+    };
+
   /**
    *  @brief  Simple object serialization implementation.
    *
@@ -672,6 +723,216 @@ namespace psi {
     }
 
 
+  /**
+   *  @brief  Read-only memory mapped file.
+   *
+   *  The file is mapped read-only. The mapping is only read while loading the objects
+   *  from the file, which are copied out of it (see `MappedIStream`).
+   */
+  class MappedFile {
+    public:
+      /* === LIFECYCLE === */
+      MappedFile( ) : addr( nullptr ), len( 0 ), opened( false ) { }
+
+      MappedFile( std::string const& file_name, bool sequential=true ) : MappedFile( )
+      {
+        this->open( file_name, sequential );
+      }
+
+      MappedFile( MappedFile const& ) = delete;
+      MappedFile& operator=( MappedFile const& ) = delete;
+
+      MappedFile( MappedFile&& other ) noexcept
+        : addr( other.addr ), len( other.len ), opened( other.opened )
+      {
+        other.addr = nullptr;
+        other.len = 0;
+        other.opened = false;
+      }
+
+      MappedFile& operator=( MappedFile&& other ) noexcept
+      {
+        this->close();
+        this->addr = other.addr;
+        this->len = other.len;
+        this->opened = other.opened;
+        other.addr = nullptr;
+        other.len = 0;
+        other.opened = false;
+        return *this;
+      }
+
+      ~MappedFile( ) noexcept
+      {
+        this->close();
+      }
+
+      /* === ACCESSORS === */
+        inline char const*
+      data( ) const
+      {
+        return static_cast< char const* >( this->addr );
+      }
+
+        inline std::size_t
+      size( ) const
+      {
+        return this->len;
+      }
+
+        inline bool
+      is_open( ) const
+      {
+        return this->opened;
+      }
+
+      /* === METHODS === */
+      /**
+       *  @brief  Map the given file into memory.
+       *
+       *  @param  file_name The name of the file to be mapped.
+       *  @param  sequential Advise the kernel that the file is read sequentially.
+       *  @return `true` if the file is successfully mapped; otherwise `false`.
+       */
+        inline bool
+      open( std::string const& file_name, bool sequential=true )
+      {
+        this->close();
+        int fd = ::open( file_name.c_str(), O_RDONLY );
+        if ( fd == -1 ) return false;
+        struct stat st;
+        if ( ::fstat( fd, &st ) == -1 ) {
+          ::close( fd );
+          return false;
+        }
+        this->len = st.st_size;
+        if ( this->len != 0 ) {  // mapping an empty file fails
+          void* ptr = ::mmap( nullptr, this->len, PROT_READ, MAP_SHARED, fd, 0 );
+          if ( ptr == MAP_FAILED ) {
+            ::close( fd );
+            this->len = 0;
+            return false;
+          }
+          this->addr = ptr;
+          ::madvise( ptr, this->len, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED );
+        }
+        ::close( fd );  // the mapping keeps a reference to the file
+        this->opened = true;
+        return true;
+      }
+
+        inline void
+      close( )
+      {
+        if ( this->addr != nullptr ) ::munmap( this->addr, this->len );
+        this->addr = nullptr;
+        this->len = 0;
+        this->opened = false;
+      }
+
+    private:
+      /* === DATA MEMBERS === */
+      void* addr;
+      std::size_t len;
+      bool opened;
+  };
+
+  /**
+   *  @brief  Stream buffer reading from a memory region (e.g. a mapped file).
+   *
+   *  Reading from the stream copies the data directly out of the mapped pages; no
+   *  system call is made and no intermediate buffer is used. The data are still
+   *  copied into the objects being read.
+   */
+  class MemoryStreamBuf : public std::streambuf {
+    public:
+      /* === LIFECYCLE === */
+      MemoryStreamBuf( char const* data=nullptr, std::size_t size=0 )
+      {
+        this->assign( data, size );
+      }
+
+      /* === METHODS === */
+        inline void
+      assign( char const* data, std::size_t size )
+      {
+        char* begin = const_cast< char* >( data );
+        this->setg( begin, begin, begin + size );
+      }
+
+    protected:
+        inline std::streamsize
+      showmanyc( ) override
+      {
+        return this->egptr() - this->gptr();
+      }
+
+        inline std::streamsize
+      xsgetn( char_type* s, std::streamsize n ) override
+      {
+        n = std::min< std::streamsize >( n, this->egptr() - this->gptr() );
+        std::memcpy( s, this->gptr(), n );
+        this->gbump( n );
+        return n;
+      }
+
+        inline pos_type
+      seekoff( off_type off, std::ios_base::seekdir dir,
+               std::ios_base::openmode which=std::ios_base::in ) override
+      {
+        char_type* base = this->eback();
+        if ( dir == std::ios_base::cur ) off += this->gptr() - base;
+        else if ( dir == std::ios_base::end ) off += this->egptr() - base;
+        return this->seekpos( off, which );
+      }
+
+        inline pos_type
+      seekpos( pos_type pos, std::ios_base::openmode which=std::ios_base::in ) override
+      {
+        if ( !( which & std::ios_base::in ) || pos < 0 ||
+             pos > this->egptr() - this->eback() ) {
+          return pos_type( off_type( -1 ) );
+        }
+        this->setg( this->eback(), this->eback() + pos, this->egptr() );
+        return pos;
+      }
+  };
+
+  /**
+   *  @brief  Input stream over a memory mapped file.
+   *
+   *  It is a drop-in replacement for `std::ifstream` when loading large binary files:
+   *  the file is not read by the stream but mapped into memory; so the loaded objects
+   *  are copied once from the page cache. It does not provide zero-copy loading: the
+   *  objects are not used in place, and they are deserialised into their own heap
+   *  buffers as with a file stream. The stream is in failed state if the file cannot
+   *  be mapped.
+   */
+  class MappedIStream : public std::istream {
+    public:
+      /* === LIFECYCLE === */
+      MappedIStream( std::string const& file_name )
+        : std::istream( nullptr ), file( file_name )
+      {
+        this->buf.assign( this->file.data(), this->file.size() );
+        this->rdbuf( &this->buf );
+        if ( !this->file.is_open() ) this->setstate( std::ios_base::failbit );
+      }
+
+      /* === ACCESSORS === */
+        inline MappedFile const&
+      get_file( ) const
+      {
+        return this->file;
+      }
+
+    private:
+      /* === DATA MEMBERS === */
+      MappedFile file;
+      MemoryStreamBuf buf;
+  };
+
+
   template< typename TObject, typename ...TArgs >
       inline void
     open( TObject& obj, std::istream& in, TArgs&&... args )
@@ -1137,7 +1398,18 @@ namespace psi {
     inline void
   deserialize( std::istream& in, std::vector< T >& container )
   {
-    deserialize( in, container, std::back_inserter( container ) );
+    if constexpr ( is_bitwise_serializable< T >::value ) {
+      static_assert( std::is_trivially_copyable< T >::value,
+                     "bitwise serialisable types should be trivially copyable" );
+      /* Items are serialised in their object representation: read them at once. */
+      DefaultContainerSize size;
+      deserialize( in, size );
+      auto offset = container.size();
+      container.resize( offset + size );
+      in.read( reinterpret_cast< char* >( container.data() + offset ), size * sizeof( T ) );
+      if ( !in ) throw std::runtime_error( "unexpected end of input" );
+    }
+    else deserialize( in, container, std::back_inserter( container ) );
   }  /* -----  end of template function deserialize  ----- */
 
   template< typename T >
@@ -1376,6 +1648,270 @@ namespace psi {
     }
   };
 
+  /**
+   *  @brief  Blocking FIFO queue with bounded capacity.
+   *
+   *  Producers block while the queue is full and consumers block while it is empty.
+   *  Closing the queue wakes all waiting threads up: no more items can be pushed into
+   *  a closed queue, while the remaining ones can still be popped.
+   */
+  template< typename T >
+  class BoundedQueue {
+    public:
+      /* === TYPE MEMBERS === */
+      typedef T value_type;
+      typedef std::size_t size_type;
+
+      /* === LIFECYCLE === */
+      BoundedQueue( size_type cap=1 ) : capacity( cap ), closed( false )
+      {
+        assert( cap != 0 );
+      }
+
+      /* === ACCESSORS === */
+        inline size_type
+      get_capacity( ) const
+      {
+        return this->capacity;
+      }
+
+      /* === METHODS === */
+      /**
+       *  @brief  Push an item into the queue; block while the queue is full.
+       *
+       *  @return `false` if the queue is closed; otherwise `true`.
+       */
+        inline bool
+      push( value_type item )
+      {
+        std::unique_lock< std::mutex > lock( this->mtx );
+        this->not_full.wait( lock, [this]() {
+            return this->closed || this->items.size() < this->capacity;
+          } );
+        if ( this->closed ) return false;
+        this->items.push_back( std::move( item ) );
+        this->not_empty.notify_one();
+        return true;
+      }
+
+      /**
+       *  @brief  Pop an item from the queue; block while the queue is empty.
+       *
+       *  @return `false` if the queue is closed and drained; otherwise `true`.
+       */
+        inline bool
+      pop( value_type& item )
+      {
+        std::unique_lock< std::mutex > lock( this->mtx );
+        this->not_empty.wait( lock, [this]() {
+            return this->closed || !this->items.empty();
+          } );
+        if ( this->items.empty() ) return false;
+        item = std::move( this->items.front() );
+        this->items.pop_front();
+        this->not_full.notify_one();
+        return true;
+      }
+
+        inline void
+      close( )
+      {
+        {
+          std::lock_guard< std::mutex > lock( this->mtx );
+          this->closed = true;
+        }
+        this->not_full.notify_all();
+        this->not_empty.notify_all();
+      }
+
+        inline bool
+      is_closed( )
+      {
+        std::lock_guard< std::mutex > lock( this->mtx );
+        return this->closed;
+      }
+
+        inline size_type
+      size( )
+      {
+        std::lock_guard< std::mutex > lock( this->mtx );
+        return this->items.size();
+      }
+
+    private:
+      /* === DATA MEMBERS === */
+      std::deque< value_type > items;
+      size_type capacity;
+      bool closed;
+      std::mutex mtx;
+      std::condition_variable not_full;
+      std::condition_variable not_empty;
+  };
+
+  /**
+   *  @brief  Growable bitmap for a set of dense integer ids (e.g. read ids).
+   *
+   *  It is a drop-in replacement for a hash set of ids when only insertion and
+   *  cardinality are required. The bitmap covers a range of ids starting from an
+   *  offset (aligned to a word), so a shard holding the ids of a reads chunk only takes
+   *  the chunk's range regardless of its first id. The underlying bit vector grows (at
+   *  least doubling) when an id out of its range is inserted; so reserving the range
+   *  beforehand (e.g. by `rebase` for each chunk) avoids resizing in the hot path.
+   *  Bitmaps filled by different threads can be merged by bitwise OR at their offsets.
+   *
+   *  NOTE: It is not thread-safe.
+   */
+  class IdBitmap {
+    public:
+      /* === TYPE MEMBERS === */
+      typedef sdsl::bit_vector bv_type;
+      typedef bv_type::size_type size_type;
+
+      /* === LIFECYCLE === */
+      IdBitmap( size_type n=0, size_type first=0 )
+        : bv( n + ( first - IdBitmap::align( first ) ), 0 ), offset( IdBitmap::align( first ) )
+      { }
+
+      /* === ACCESSORS === */
+        inline bv_type const&
+      get_bv( ) const
+      {
+        return this->bv;
+      }
+
+      /**
+       *  @brief  The first id in the range of the bitmap.
+       */
+        inline size_type
+      get_offset( ) const
+      {
+        return this->offset;
+      }
+
+      /**
+       *  @brief  The number of ids from the offset that the bitmap can hold without
+       *          resizing.
+       */
+        inline size_type
+      capacity( ) const
+      {
+        return this->bv.size();
+      }
+
+      /* === OPERATORS === */
+        inline IdBitmap&
+      operator|=( IdBitmap const& other )
+      {
+        if ( other.capacity() == 0 ) return *this;
+        this->extend( other.offset, other.offset + other.capacity() );
+        auto dst = this->bv.data() + ( ( other.offset - this->offset ) >> 6 );
+        auto src = other.bv.data();
+        for ( size_type i = 0; i < words( other.capacity() ); ++i ) dst[ i ] |= src[ i ];
+        return *this;
+      }
+
+      /* === METHODS === */
+      /**
+       *  @brief  Make sure that ids in [offset, n) can be inserted without resizing.
+       */
+        inline void
+      reserve( size_type n )
+      {
+        if ( n <= this->offset ) return;
+        this->extend( this->offset, n );
+      }
+
+      /**
+       *  @brief  Clear the bitmap and move its range to [first, last).
+       *
+       *  The storage is reused if it is large enough.
+       */
+        inline void
+      rebase( size_type first, size_type last )
+      {
+        this->offset = IdBitmap::align( first );
+        if ( last - this->offset > this->bv.size() ) {
+          bv_type nbv( last - this->offset, 0 );
+          this->bv.swap( nbv );
+        }
+        else {
+          this->clear();
+        }
+      }
+
+        inline void
+      insert( size_type id )
+      {
+        if ( id < this->offset || id - this->offset >= this->bv.size() ) {
+          this->extend( id, id + 1 );
+        }
+        this->bv[ id - this->offset ] = 1;
+      }
+
+        inline bool
+      contains( size_type id ) const
+      {
+        return id >= this->offset && id - this->offset < this->bv.size() &&
+            this->bv[ id - this->offset ];
+      }
+
+      /**
+       *  @brief  The number of ids in the set.
+       */
+        inline size_type
+      count( ) const
+      {
+        return sdsl::util::cnt_one_bits( this->bv );
+      }
+
+        inline void
+      clear( )
+      {
+        sdsl::util::set_to_value( this->bv, 0 );
+      }
+
+    private:
+      /* === DATA MEMBERS === */
+      bv_type bv;
+      size_type offset;  /**< @brief The first id in the range (multiple of 64). */
+
+      /* === METHODS === */
+        constexpr static inline size_type
+      words( size_type nbits )
+      {
+        return ( nbits + 63 ) >> 6;
+      }
+
+        constexpr static inline size_type
+      align( size_type id )
+      {
+        return id & ~size_type( 63 );
+      }
+
+      /**
+       *  @brief  Extend the range of the bitmap to cover [first, last).
+       */
+        inline void
+      extend( size_type first, size_type last )
+      {
+        size_type end = this->offset + this->bv.size();
+        if ( first >= this->offset && last <= end ) return;
+        if ( this->bv.size() == 0 ) {
+          this->rebase( first, last );
+          return;
+        }
+        size_type noffset = IdBitmap::align( std::min( first, this->offset ) );
+        size_type nend = std::max( last, end );
+        /* Grow by at least doubling to amortise repeated insertions out of the range. */
+        nend = std::max( nend, noffset + 2 * this->bv.size() );
+        bv_type nbv( nend - noffset, 0 );
+        std::copy( this->bv.data(), this->bv.data() + words( this->bv.size() ),
+                   nbv.data() + ( ( this->offset - noffset ) >> 6 ) );
+        this->bv.swap( nbv );
+        this->offset = noffset;
+      }
+  };
+
   /* Meta-functions */
   template< typename T1, typename T2 >
     using enable_if_equal = std::enable_if< std::is_same< T1, T2 >::value, T2 >;
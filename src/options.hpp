@@ -22,6 +22,7 @@
 #include <string>
 
 #include <seqan/index.h>
+#include <psi/index.hpp>
 
 
 namespace psi {
@@ -37,6 +38,8 @@ namespace psi {
 
   typedef seqan2::IndexWotd<> UsingIndexWotd;
   typedef seqan2::IndexEsa<> UsingIndexEsa;
+  typedef KmerIndex<> UsingIndexQGram;
+  typedef CFMIndex UsingIndexFM;
 
     inline IndexType
   index_from_str(std::string str)
@@ -64,6 +67,32 @@ namespace psi {
     throw std::runtime_error("Undefined index type.");
   }
 
+  enum class SamplingProfile {
+    Fast = 1,             /**< @brief Dense SA samples: faster locate, larger index. */
+    Default,              /**< @brief Default SA/ISA sampling densities. */
+    Compact               /**< @brief Sparse SA samples: smaller index, slower locate. */
+  };
+
+    inline SamplingProfile
+  sampling_from_str(std::string str)
+  {
+    if (str == "fast") return SamplingProfile::Fast;
+    if (str == "default") return SamplingProfile::Default;
+    if (str == "compact") return SamplingProfile::Compact;
+
+    throw std::runtime_error("Undefined sampling profile.");
+  }
+
+    inline std::string
+  sampling_to_str(SamplingProfile sampling)
+  {
+    if (sampling == SamplingProfile::Fast) return std::string("fast");
+    if (sampling == SamplingProfile::Default) return std::string("default");
+    if (sampling == SamplingProfile::Compact) return std::string("compact");
+
+    throw std::runtime_error("Undefined sampling profile.");
+  }
+
   typedef struct
   {
     unsigned int seed_len;
@@ -76,7 +105,10 @@ namespace psi {
     unsigned int max_mem;
     unsigned int dindex_min_ris;
     unsigned int dindex_max_ris;
+    unsigned int threads;
+    unsigned int qgram_len;
     IndexType index;
+    SamplingProfile sampling;
     std::string rf_path;
     std::string fq_path;
     std::string output_path;
@@ -84,7 +116,10 @@ namespace psi {
     std::string pindex_path;
     std::string dindex_mode;
     bool patched;
+    bool compact;
     bool indexonly;
+    bool loci_index;
+    bool graph_snapshot;
     bool nologfile;
     bool nolog;
     bool quiet;
@@ -21,8 +21,13 @@
 #include <sstream>
 #include <string>
 #include <functional>
-#include <unordered_set>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <exception>
 #include <stdexcept>
+#include <type_traits>
 
 #include <gum/graph.hpp>
 #include <gum/io_utils.hpp>
@@ -32,6 +37,7 @@
 #include <psi/seed_finder.hpp>
 #include <psi/sequence.hpp>
 #include <psi/seed.hpp>
+#include <psi/seed_io.hpp>
 #include <psi/utils.hpp>
 #include <psi/stats.hpp>
 #include <psi/release.hpp>
@@ -56,9 +62,9 @@ using namespace psi;
 // TODO: inconsistency: some public methods are interface functions, some are members.
 // TODO: Add value_t< T > typedef as typename seqan2::Value< T >::Type
 
-template< typename TSeedFinder, typename TSet >
+template< typename TSeedFinder >
     void
-  report( TSeedFinder& finder, TSet& covered_reads, unsigned long long int found )
+  report( TSeedFinder& finder, IdBitmap const& covered_reads, unsigned long long int found )
   {
     typedef typename TSeedFinder::stats_type::timer_type timer_type;
 
@@ -68,7 +74,7 @@ template< typename TSeedFinder, typename TSet >
     log->info( "Total number of seeds found: {}", found );
     log->info( "-> of which found off paths: {}",
       TSeedFinder::traverser_type::stats_type::get_total_seeds_off_paths() );
-    log->info( "Total number of reads covered: {}", covered_reads.size() );
+    log->info( "Total number of reads covered: {}", covered_reads.count() );
     log->info( "Total number of 'godown' operations: {}",
       TSeedFinder::traverser_type::stats_type::get_total_nof_godowns() );
 
@@ -80,23 +86,364 @@ template< typename TSeedFinder, typename TSet >
   }
 
 
-template< class TGraph, typename TReadsIndexSpec >
+/**
+ *  @brief  Get the longest period measured by a timer among all threads.
+ *
+ *  The stages run by a pool of threads are timed by each worker; so the longest one
+ *  is the time taken by the stage rather than the one of the calling thread.
+ */
+template< typename TStats >
+    typename TStats::timer_type::period_type
+  get_max_timer( TStats const& stats, std::string const& name )
+  {
+    typename TStats::timer_type::period_type result;
+    for ( auto const& tstats : stats.get_threads_stats() ) {
+      auto period = stats.get_timer( name, tstats.first );
+      if ( period.duration() > result.duration() ) result = period;
+    }
+    return result;
+  }
+
+
+/**
+ *  @brief  Find seeds for all reads using a pool of worker threads.
+ *
+ *  Each worker owns its reads chunk, the seeds and their index, and a traverser
+ *  created by the finder; while the (const) seed finder is shared among all of them.
+ *  Loading a chunk from the input stream is serialised, so is passing the found seeds
+ *  to the seed writer which is done once per chunk from the worker's local buffer.
+ *  Covered reads are marked in a per-worker bitmap shard covering only the id range
+ *  of the current chunk, which is merged into the global bitmap along with the seeds.
+ */
+template< typename TSeedFinder, typename TSeedWriter >
+    void
+  find_seeds_parallel( TSeedFinder const& finder, SeqStreamIn& reads_iss,
+                       TSeedWriter& writer, Options const& params,
+                       unsigned long long int& found, IdBitmap& covered_reads )
+  {
+    typedef typename TSeedFinder::traverser_type traverser_type;
+    typedef typename traverser_type::output_type output_type;
+
+    auto log = get_logger( "main" );
+    std::mutex input_lock;
+    std::mutex output_lock;
+    std::exception_ptr eptr = nullptr;
+
+    auto worker = [&]( unsigned int wid ) {
+      try {
+        auto const& stats = finder.get_stats();
+        auto tid = get_thread_id();
+        auto chunk = finder.create_readrecord();
+        auto seeds = finder.create_readrecord();
+        auto traverser = finder.create_traverser();
+        std::vector< output_type > hits;
+        IdBitmap covered;
+        auto callback =
+            [&hits, &covered]( output_type const& seed_hit ) {
+              hits.push_back( seed_hit );
+              covered.insert( seed_hit.read_id );
+            };
+
+        while ( true ) {
+          {
+            std::lock_guard< std::mutex > lock( input_lock );
+            if ( eptr ) break;
+            /* Load a chunk from reads set. */
+            if ( !readRecords( chunk, reads_iss, params.chunk_size ) ) break;
+          }
+          log->info( "Worker {} fetched {} reads with total length of {}bp.", wid,
+                     length( chunk ), lengthSum( chunk.str ) );
+          covered.rebase( chunk.get_record_offset(),
+                          chunk.get_record_offset() + length( chunk ) );
+          finder.get_seeds( seeds, chunk, params.distance );
+          auto seeds_index = finder.index_reads( seeds );
+          finder.seeds_all( seeds, seeds_index, traverser, callback );
+          {
+            std::lock_guard< std::mutex > lock( output_lock );
+            for ( auto const& seed_hit : hits ) writer.push( seed_hit );
+            found += hits.size();
+            covered_reads |= covered;
+          }
+          log->info( "Worker {} found {} seeds in the chunk (seeding: {}, on paths: {}, "
+                     "off paths: {}).", wid, hits.size(),
+                     stats.get_timer( "seeding", tid ).str(),
+                     stats.get_timer( "seeds-on-paths", tid ).str(),
+                     stats.get_timer( "seeds-off-paths", tid ).str() );
+          hits.clear();
+        }
+      }
+      catch ( ... ) {
+        std::lock_guard< std::mutex > lock( input_lock );
+        if ( !eptr ) eptr = std::current_exception();
+      }
+    };
+
+    std::vector< std::thread > workers;
+    workers.reserve( params.threads );
+    for ( unsigned int i = 0; i < params.threads; ++i ) workers.emplace_back( worker, i + 1 );
+    for ( auto& w : workers ) w.join();
+    if ( eptr ) std::rethrow_exception( eptr );
+  }
+
+
+/**
+ *  @brief  Find seeds for all reads in a staged pipeline.
+ *
+ *  A reader thread loads the next read chunks and a preparer thread computes their
+ *  seeds and builds the seeds index, while the current chunk is being traversed by the
+ *  calling thread. The stages are connected by bounded queues so that at most one
+ *  chunk is waiting in between any two stages (double buffering). The id range of
+ *  each chunk is reserved in the covered reads bitmap before it is traversed.
+ */
+template< typename TSeedFinder >
+    void
+  find_seeds_pipelined( TSeedFinder const& finder, SeqStreamIn& reads_iss,
+                        Options const& params,
+                        std::function< void( typename TSeedFinder::traverser_type::output_type const& ) > callback,
+                        IdBitmap& covered_reads )
+  {
+    typedef typename TSeedFinder::readsrecord_type readsrecord_type;
+    typedef typename TSeedFinder::readsindex_type readsindex_type;
+    typedef typename TSeedFinder::stats_type::timer_type timer_type;
+
+    struct PreparedChunk {
+      std::unique_ptr< readsrecord_type > seeds;
+      std::unique_ptr< readsindex_type > index;
+      std::size_t end_id;  /**< @brief One past the last read id of the chunk. */
+    };
+
+    constexpr const std::size_t QUEUE_CAPACITY = 1;
+
+    auto log = get_logger( "main" );
+    auto const& stats = finder.get_stats();
+    auto tid = get_thread_id();
+    BoundedQueue< std::unique_ptr< readsrecord_type > > chunks( QUEUE_CAPACITY );
+    BoundedQueue< std::unique_ptr< PreparedChunk > > prepared( QUEUE_CAPACITY );
+    std::exception_ptr eptr = nullptr;
+    std::mutex eptr_lock;
+
+    auto fail = [&]( ) {
+      {
+        std::lock_guard< std::mutex > lock( eptr_lock );
+        if ( !eptr ) eptr = std::current_exception();
+      }
+      chunks.close();
+      prepared.close();
+    };
+
+    std::thread reader( [&]( ) {
+        try {
+          while ( true ) {
+            auto chunk = std::make_unique< readsrecord_type >( );
+            {
+              [[maybe_unused]] auto timer = timer_type( "load-chunk" );
+              /* Load a chunk from reads set. */
+              if ( !readRecords( *chunk, reads_iss, params.chunk_size ) ) break;
+            }
+            log->info( "Fetched {} reads with total length of {}bp (load-chunk: {}).",
+                       length( *chunk ), lengthSum( chunk->str ),
+                       timer_type::get_duration_str( "load-chunk" ) );
+            if ( !chunks.push( std::move( chunk ) ) ) break;
+          }
+          chunks.close();
+        }
+        catch ( ... ) {
+          fail();
+        }
+      } );
+
+    std::thread preparer( [&]( ) {
+        try {
+          auto ptid = get_thread_id();
+          std::unique_ptr< readsrecord_type > chunk;
+          while ( chunks.pop( chunk ) ) {
+            auto item = std::make_unique< PreparedChunk >();
+            item->end_id = chunk->get_record_offset() + length( *chunk );
+            item->seeds = std::make_unique< readsrecord_type >( );
+            finder.get_seeds( *item->seeds, *chunk, params.distance );
+            item->index = std::make_unique< readsindex_type >( finder.index_reads( *item->seeds ) );
+            {
+              /* Evaluate the lazy index here rather than during traversal. */
+              [[maybe_unused]] auto timer = stats.timeit_ts( "index-reads" );
+              create_index( *item->index );
+            }
+            chunk.reset();
+            log->info( "Seeding done in {}; indexed seeds in {}.",
+                       stats.get_timer( "seeding", ptid ).str(),
+                       stats.get_timer( "index-reads", ptid ).str() );
+            if ( !prepared.push( std::move( item ) ) ) break;
+          }
+          prepared.close();
+        }
+        catch ( ... ) {
+          fail();
+        }
+      } );
+
+    try {
+      auto traverser = finder.create_traverser();
+      std::unique_ptr< PreparedChunk > item;
+      while ( prepared.pop( item ) ) {
+        log->info( "Finding all seeds..." );
+        covered_reads.reserve( item->end_id );
+        finder.seeds_all( *item->seeds, *item->index, traverser, callback );
+        log->info( "Found seeds on paths in {}.", stats.get_timer( "seeds-on-paths", tid ).str() );
+        log->info( "Found seeds off paths in {}.", stats.get_timer( "seeds-off-paths", tid ).str() );
+        log->info( "Verified distance constraints in {}.", stats.get_timer( "query-dindex", tid ).str() );
+      }
+    }
+    catch ( ... ) {
+      fail();
+    }
+
+    reader.join();
+    preparer.join();
+    if ( eptr ) std::rethrow_exception( eptr );
+  }
+
+
+/**
+ *  @brief  Find seeds for all reads and write them using the given seed writer.
+ */
+template< typename TSeedFinder, typename TSeedWriter >
+    void
+  seed_reads( TSeedFinder const& finder, SeqStreamIn& reads_iss, TSeedWriter& writer,
+              Options const& params )
+  {
+    typedef typename TSeedFinder::traverser_type traverser_type;
+    typedef typename TSeedFinder::stats_type::timer_type timer_type;
+
+    /* Get the main logger. */
+    auto log = get_logger( "main" );
+    auto tid = get_thread_id();
+    auto const& stats = finder.get_stats();
+
+    unsigned long long int found = 0;
+    IdBitmap covered_reads;
+    std::function< void(typename traverser_type::output_type const &) > write_callback =
+      [&found, &writer, &covered_reads]
+      (typename traverser_type::output_type const & seed_hit) {
+      ++found;
+      writer.push( seed_hit );
+      covered_reads.insert(seed_hit.read_id);
+    };
+    /* Used when the seeds of a single chunk are found by multiple threads: each thread
+     * buffers its seeds and passes them to the writer under the lock once per batch. */
+    std::mutex write_lock;
+    auto sync_write_callback = make_seed_batch_sink< typename traverser_type::output_type >(
+        [&write_lock, &found, &writer, &covered_reads]
+        ( typename traverser_type::output_type const* hits, std::size_t count ) {
+          std::lock_guard< std::mutex > lock( write_lock );
+          for ( std::size_t i = 0; i < count; ++i ) {
+            writer.push( hits[ i ] );
+            covered_reads.insert( hits[ i ].read_id );
+          }
+          found += count;
+        } );
+
+    /* Found seeds in chunks using multiple threads. */
+    if ( params.threads > 1 && params.chunk_size != 0 ) {
+      log->info( "Finding seeds using {} threads...", params.threads );
+      [[maybe_unused]] auto timer = timer_type( "seed-finding" );
+      find_seeds_parallel( finder, reads_iss, writer, params, found, covered_reads );
+    }
+    /* Found seeds in chunks: load, prepare and traverse them in a pipeline. */
+    else if ( params.chunk_size != 0 ) {
+      log->info( "Finding seeds..." );
+      [[maybe_unused]] auto timer = timer_type( "seed-finding" );
+      find_seeds_pipelined( finder, reads_iss, params, write_callback, covered_reads );
+    }
+    /* Found seeds in one chunk. */
+    else {
+      auto chunk = finder.create_readrecord();
+      auto seeds = finder.create_readrecord();
+      auto traverser = finder.create_traverser();
+      log->info( "Finding seeds..." );
+      [[maybe_unused]] auto timer = timer_type( "seed-finding" );
+      while ( true ) {
+        log->info( "Loading a read chunk..." );
+        {
+          [[maybe_unused]] auto timer = timer_type( "load-chunk" );
+          /* Load a chunk from reads set. */
+          if ( !readRecords( chunk, reads_iss, params.chunk_size ) ) break;
+        }
+        log->info( "Fetched {} reads with total length of {}bp in {}.", length( chunk ),
+                   lengthSum( chunk.str ), timer_type::get_duration_str( "load-chunk" ) );
+        covered_reads.reserve( chunk.get_record_offset() + length( chunk ) );
+        /* Give the current chunk to the finder. */
+        finder.get_seeds( seeds, chunk, params.distance );
+        auto seeds_index = finder.index_reads( seeds );
+        log->info( "Seeding done in {}.", stats.get_timer( "seeding", tid ).str() );
+        log->info( "Finding all seeds..." );
+        /* All reads in one chunk: traverse the starting loci using multiple threads. */
+        if ( params.threads > 1 ) {
+          finder.seeds_all( seeds, seeds_index, sync_write_callback, params.threads );
+        }
+        else finder.seeds_all( seeds, seeds_index, traverser, write_callback );
+        log->info( "Found seeds on paths in {}.", stats.get_timer( "seeds-on-paths", tid ).str() );
+        if ( params.threads > 1 ) {
+          log->info( "Found seeds off paths in {} (longest of {} threads).",
+                     get_max_timer( stats, "seeds-off-paths" ).str(), params.threads );
+        }
+        else {
+          log->info( "Found seeds off paths in {}.",
+                     stats.get_timer( "seeds-off-paths", tid ).str() );
+        }
+        log->info( "Verified distance constraints in {}.", stats.get_timer( "query-dindex", tid ).str() );
+      }
+    }
+    log->info( "Found seed in {}.", timer_type::get_duration_str( "seed-finding" ) );
+    writer.flush();
+    report( finder, covered_reads, found );
+  }
+
+
+/**
+ *  @brief  Log the memory/locate trade-off of the path index sampling profile.
+ */
+template< typename TSeedFinder >
+    void
+  report_sampling( TSeedFinder const& finder, Options const& params )
+  {
+    typedef typename TSeedFinder::pathindex_type::index_type pindex_type;
+
+    auto log = get_logger( "main" );
+    auto const& index = finder.get_pindex().index;
+    double mib = 1024.0 * 1024.0;
+    log->info( "Path index sampling profile: {} (SA/ISA sample densities: {}/{})",
+               sampling_to_str( params.sampling ),
+               pindex_type::SA_SAMPLE_DENS, pindex_type::ISA_SAMPLE_DENS );
+    log->info( "Path FM index size: {:.2f} MiB (SA/ISA samples: {:.2f} MiB); "
+               "at most {} LF steps per located occurrence",
+               index.size_in_bytes() / mib, index.samples_size_in_bytes() / mib,
+               pindex_type::SA_SAMPLE_DENS - 1 );
+  }
+
+
+/**
+ *  @brief  Find seeds for all reads.
+ *
+ *  The graph is loaded by `load_graph` concurrently with the path index components.
+ */
+template< class TGraph, typename TReadsIndexSpec, typename TPathIndexSpec >
     void
-  find_seeds( TGraph& graph, SeqStreamIn& reads_iss, seqan2::File<>& output_file,
-              Options const& params, TReadsIndexSpec const )
+  find_seeds( TGraph& graph, std::function< void() > load_graph, SeqStreamIn& reads_iss,
+              std::ostream& output, Options const& params, TReadsIndexSpec const,
+              TPathIndexSpec const )
   {
     /* typedefs */
     typedef Dna5QStringSet<> readsstringset_type;
     typedef SeedFinderTraits< typename TGraph::spec_type,
-                              readsstringset_type, TReadsIndexSpec > finder_traits_type;
+                              readsstringset_type, TReadsIndexSpec,
+                              DiskBased, BFS, ExactMatching,
+                              TPathIndexSpec > finder_traits_type;
 #ifdef PSI_STATS
     typedef SeedFinder< WithStats, finder_traits_type > finder_type;
 #else
     typedef SeedFinder< NoStats, finder_traits_type > finder_type;
 #endif
     typedef typename finder_type::traverser_type traverser_type;
-    typedef typename finder_type::stats_type stats_type;
-    typedef typename stats_type::timer_type timer_type;
+    typedef typename finder_type::stats_type::timer_type timer_type;
 
     /* Get the main logger. */
     auto log = get_logger( "main" );
@@ -109,13 +456,42 @@ template< class TGraph, typename TReadsIndexSpec >
     auto const& stats = finder.get_stats();
     /* Prepare (load or create) genome-wide paths. */
     log->info( "Looking for an existing path index..." );
-    /* Load the genome-wide path index for the graph if available. */
-    if ( finder.load_path_index( params.pindex_path,
-                                 params.context,
-                                 params.step_size,
-                                 params.dindex_min_ris,
-                                 params.dindex_max_ris ) ) {
+    /* Load the genome-wide path index for the graph (if available) along with the graph. */
+    bool loaded;
+    try {
+      loaded = finder.load_path_index( params.pindex_path,
+                                       params.context,
+                                       params.step_size,
+                                       params.dindex_min_ris,
+                                       params.dindex_max_ris,
+                                       [&load_graph, &finder, &params]( ) {
+                                         {
+                                           [[maybe_unused]] auto timer = timer_type( "load-graph" );
+                                           load_graph();
+                                         }
+                                         if ( params.graph_snapshot ) finder.create_graph_snapshot();
+                                       } );
+    }
+    catch ( const std::runtime_error& e ) {
+      /* An existing path index is never overwritten on an error (e.g. another sampling
+       * profile); it should be removed explicitly to be rebuilt. */
+      log->error( "Failed to load the graph or the path index '{}': {}", params.pindex_path,
+                  e.what() );
+      log->error( "An existing path index is not rebuilt on errors; e.g. use the sampling "
+                  "profile it was built with, or remove it explicitly to rebuild it." );
+      throw;
+    }
+    log->info( "Loaded graph in {}.", timer_type::get_duration_str( "load-graph" ) );
+    if ( params.graph_snapshot ) {
+      log->info( "Took a snapshot of the graph in {}.",
+                 stats.get_timer( "graph-snapshot", tid ).str() );
+    }
+    if ( loaded ) {
       log->info( "The path index has been found and loaded." );
+      log->info( "Loaded paths index in {}.", stats.get_timer( "load-pindex" ).str() );
+      log->info( "Loaded paths set in {}.", stats.get_timer( "load-paths" ).str() );
+      log->info( "Loaded starting loci in {}.", stats.get_timer( "load-starts" ).str() );
+      log->info( "Loaded distance index in {}.", stats.get_timer( "load-dindex" ).str() );
     }
     /* No genome-wide path index requested. */
     else if ( params.path_num == 0 ) {
@@ -131,13 +507,15 @@ template< class TGraph, typename TReadsIndexSpec >
         finder.create_path_index( params.path_num, params.patched,
                                   params.context, params.step_size,
                                   params.dindex_min_ris, params.dindex_max_ris,
-                                  psi::Whole{}, info_cb, warn_cb );
+                                  psi::Whole{}, info_cb, warn_cb, params.threads,
+                                  params.qgram_len );
       }
       else if ( params.dindex_mode == "per-component" ) {
         finder.create_path_index( params.path_num, params.patched,
                                   params.context, params.step_size,
                                   params.dindex_min_ris, params.dindex_max_ris,
-                                  psi::PerComponent{}, info_cb, warn_cb );
+                                  psi::PerComponent{}, info_cb, warn_cb, params.threads,
+                                  params.qgram_len );
       }
       else {
         throw std::runtime_error( "Unknown distance index construction mode: "
@@ -158,6 +536,7 @@ template< class TGraph, typename TReadsIndexSpec >
         log->info( "Saved distance index in {}.", stats.get_timer( "save-dindex", tid ).str() );
       }
     }
+    if ( loaded || params.path_num != 0 ) report_sampling( finder, params );
     log->info( "Number of starting loci (in {} nodes of total {}): {}",
         finder.get_nof_uniq_nodes(), finder.get_graph_ptr()->get_node_count(),
         finder.get_starting_loci().size() );
@@ -167,48 +546,70 @@ template< class TGraph, typename TReadsIndexSpec >
       return;
     }
 
-    unsigned long long int found = 0;
-    std::unordered_set< Records< readsstringset_type >::TPosition > covered_reads;
-    std::function< void(typename traverser_type::output_type const &) > write_callback =
-      [&found, &output_file, &covered_reads]
-      (typename traverser_type::output_type const & seed_hit) {
-      ++found;
-      write( output_file, &seed_hit.node_id, 1 );
-      write( output_file, &seed_hit.node_offset, 1 );
-      write( output_file, &seed_hit.read_id, 1 );
-      write( output_file, &seed_hit.read_offset, 1 );
-      covered_reads.insert(seed_hit.read_id);
-    };
+    /* The starting loci index is not persisted; it is rebuilt on each run. */
+    if ( params.loci_index ) {
+      if ( params.seed_len > finder_type::lociindex_type::MAX_K ) {
+        log->warn( "Starting loci index requires seed length of at most {}. Skipping...",
+                   finder_type::lociindex_type::MAX_K );
+      }
+      else {
+        log->info( "Indexing starting loci k-mers..." );
+        finder.create_loci_index( params.threads );
+        log->info( "Indexed starting loci k-mers in {}.",
+                   stats.get_timer( "index-loci", tid ).str() );
+      }
+    }
 
-    /* Found seeds in chunks. */
-    {
-      auto chunk = finder.create_readrecord();
-      auto seeds = finder.create_readrecord();
-      auto traverser = finder.create_traverser();
-      log->info( "Finding seeds..." );
-      [[maybe_unused]] auto timer = timer_type( "seed-finding" );
-      while ( true ) {
-        log->info( "Loading a read chunk..." );
-        {
-          [[maybe_unused]] auto timer = timer_type( "load-chunk" );
-          /* Load a chunk from reads set. */
-          if ( !readRecords( chunk, reads_iss, params.chunk_size ) ) break;
-        }
-        log->info( "Fetched {} reads with total length of {}bp in {}.", length( chunk ),
-                   lengthSum( chunk.str ), timer_type::get_duration_str( "load-chunk" ) );
-        /* Give the current chunk to the finder. */
-        finder.get_seeds( seeds, chunk, params.distance );
-        auto seeds_index = finder.index_reads( seeds );
-        log->info( "Seeding done in {}.", stats.get_timer( "seeding", tid ).str() );
-        log->info( "Finding all seeds..." );
-        finder.seeds_all( seeds, seeds_index, traverser, write_callback );
-        log->info( "Found seeds on paths in {}.", stats.get_timer( "seeds-on-paths", tid ).str() );
-        log->info( "Found seeds off paths in {}.", stats.get_timer( "seeds-off-paths", tid ).str() );
-        log->info( "Verified distance constraints in {}.", stats.get_timer( "query-dindex", tid ).str() );
+    /* Write seeds in the requested layout. */
+    if ( params.compact ) {
+      SeedWriter< CompactLayout, typename traverser_type::output_type > writer( output );
+      seed_reads( finder, reads_iss, writer, params );
+    }
+    else {
+      SeedWriter< PlainLayout, typename traverser_type::output_type > writer( output );
+      seed_reads( finder, reads_iss, writer, params );
+    }
+  }
+
+
+/**
+ *  @brief  Find seeds for all reads using the requested path index sampling profile.
+ *
+ *  Non-default sampling profiles are only instantiated for the WOTD and FM reads
+ *  indexes in order to keep the number of seed finder instantiations down.
+ */
+template< class TGraph, typename TReadsIndexSpec >
+    void
+  find_seeds( TGraph& graph, std::function< void() > load_graph, SeqStreamIn& reads_iss,
+              std::ostream& output, Options const& params, TReadsIndexSpec const )
+  {
+    constexpr bool profiled = std::is_same< TReadsIndexSpec, UsingIndexWotd >::value ||
+        std::is_same< TReadsIndexSpec, UsingIndexFM >::value;
+
+    if ( params.sampling == SamplingProfile::Default ) {
+      find_seeds( graph, load_graph, reads_iss, output, params,
+                  TReadsIndexSpec(), FMIndex<>() );
+      return;
+    }
+
+    if constexpr ( profiled ) {
+      switch ( params.sampling ) {
+        case SamplingProfile::Fast: find_seeds( graph, load_graph, reads_iss, output, params,
+                                        TReadsIndexSpec(), FastFMIndex() );
+                                    return;
+        case SamplingProfile::Compact: find_seeds( graph, load_graph, reads_iss, output, params,
+                                           TReadsIndexSpec(), CompactFMIndex() );
+                                       return;
+        default: break;
       }
+      throw std::runtime_error("Sampling profile not implemented.");
+    }
+    else {
+      std::string msg = "Path index sampling profile '" + sampling_to_str( params.sampling ) +
+          "' is only supported with the WOTD and FM reads indexes.";
+      get_logger( "main" )->error( msg );
+      throw std::runtime_error( msg );
     }
-    log->info( "Found seed in {}.", timer_type::get_duration_str( "seed-finding" ) );
-    report( finder, covered_reads, found );
   }
 
 
@@ -223,6 +624,7 @@ startup( const Options & options )
   log->info( "- Context size (used in patching): {}", options.context );
   log->info( "- Patched: {}", ( options.patched ? "yes" : "no" ) );
   log->info( "- Path index file: '{}'", options.pindex_path );
+  log->info( "- Path index sampling profile: {}", sampling_to_str( options.sampling ) );
   log->info( "- Reads chunk size: {}", options.chunk_size );
   log->info( "- Reads index type: {}", index_to_str(options.index) );
   log->info( "- Step size: {}", options.step_size );
@@ -231,8 +633,12 @@ startup( const Options & options )
   log->info( "- Distance index minimum read insert size: {}", options.dindex_min_ris );
   log->info( "- Distance index maximum read insert size: {}", options.dindex_max_ris );
   log->info( "- Distance index construction mode: {}", options.dindex_mode );
+  log->info( "- Number of threads: {}", options.threads );
   log->info( "- Temporary directory: '{}'", get_tmpdir() );
   log->info( "- Output file: '{}'", options.output_path );
+  log->info( "- Output layout: {}", ( options.compact ? "compact" : "plain" ) );
+  log->info( "- Starting loci index: {}", ( options.loci_index ? "yes" : "no" ) );
+  log->info( "- Graph snapshot: {}", ( options.graph_snapshot ? "yes" : "no" ) );
 
   log->info( "Loading input graph from file '{}'...", options.rf_path );
 
@@ -247,12 +653,15 @@ startup( const Options & options )
   };
 
   gum::SeqGraph< gum::Succinct > graph;
-  gum::ExternalLoader< vg::Graph > loader{ parse_vg };
-  gum::util::load( graph, options.rf_path, loader, true );
-  if ( gum::util::ids_in_topological_order( graph ) ) {
-    log->info( "Input graph node IDs are in topological sort order." );
-  }
-  else log->warn( "Input graph node IDs are NOT in topological sort order." );
+  /* The graph is loaded by the seed finder concurrently with the path index. */
+  auto load_graph = [&]( ) {
+    gum::ExternalLoader< vg::Graph > loader{ parse_vg };
+    gum::util::load( graph, options.rf_path, loader, true );
+    if ( gum::util::ids_in_topological_order( graph ) ) {
+      log->info( "Input graph node IDs are in topological sort order." );
+    }
+    else log->warn( "Input graph node IDs are NOT in topological sort order." );
+  };
 
   log->info( "Opening reads file '{}'...", options.fq_path );
   SeqStreamIn reads_iss( options.fq_path.c_str() );
@@ -262,27 +671,51 @@ startup( const Options & options )
     throw std::runtime_error( msg );
   }
 
-  seqan2::File<> output_file;
-  auto mode = seqan2::OPEN_CREATE | seqan2::OPEN_WRONLY;
-  if ( !open( output_file, options.output_path.c_str(), mode ) ) {
+  std::ofstream output_file( options.output_path, std::ofstream::out | std::ofstream::binary );
+  if ( !output_file ) {
     std::string msg = "could not open file '" + options.output_path + "'!";
     log->error( msg );
     throw std::runtime_error( msg );
   }
 
+  if ( options.index == IndexType::QGram &&
+       options.seed_len > seqan2::Index< Dna5QStringSet<>, UsingIndexQGram >::MAX_K ) {
+    std::string msg = "seed length should be at most " +
+        std::to_string( seqan2::Index< Dna5QStringSet<>, UsingIndexQGram >::MAX_K ) +
+        " when using QGRAM index";
+    log->error( msg );
+    throw std::runtime_error( msg );
+  }
+
   switch ( options.index ) {
     case IndexType::Wotd: find_seeds( graph,
+                              load_graph,
                               reads_iss,
                               output_file,
                               options,
                               UsingIndexWotd() );
                           break;
     case IndexType::Esa: find_seeds( graph,
+                             load_graph,
                              reads_iss,
                              output_file,
                              options,
                              UsingIndexEsa() );
                          break;
+    case IndexType::QGram: find_seeds( graph,
+                               load_graph,
+                               reads_iss,
+                               output_file,
+                               options,
+                               UsingIndexQGram() );
+                           break;
+    case IndexType::FM: find_seeds( graph,
+                            load_graph,
+                            reads_iss,
+                            output_file,
+                            options,
+                            UsingIndexFM() );
+                        break;
     default: throw std::runtime_error("Index not implemented.");
              break;
   }
@@ -317,6 +750,10 @@ setup_argparser( seqan2::ArgumentParser& parser )
         "Output file.",
         seqan2::ArgParseArgument::OUTPUT_FILE, "OUTPUT_FILE" ) );
   setDefaultValue( parser, "o", "out.gam" );
+  // compact output layout
+  addOption( parser,
+      seqan2::ArgParseOption( "z", "compact",
+        "Write seeds in compact layout (grouped by read id, delta and varint encoded)." ) );
   // path index file
   addOption( parser,
       seqan2::ArgParseOption( "I", "path-index",
@@ -395,6 +832,27 @@ setup_argparser( seqan2::ArgumentParser& parser )
                                     seqan2::ArgParseArgument::STRING, "MODE" ) );
   setValidValues( parser, "dindex-mode", "per-component whole" );
   setDefaultValue( parser, "dindex-mode", "per-component" );
+  // path index q-gram table
+  addOption( parser,
+             seqan2::ArgParseOption( "", "qgram-length",
+                                    "Length of q-grams in the path index lookup table used to "
+                                    "skip the first q search steps (no table by default).",
+                                    seqan2::ArgParseArgument::INTEGER, "INT" ) );
+  setMinValue( parser, "qgram-length", "0" );
+  setMaxValue( parser, "qgram-length", "16" );
+  setDefaultValue( parser, "qgram-length", 0 );
+  // path index sampling profile
+  addOption( parser,
+             seqan2::ArgParseOption( "", "pindex-sampling",
+                                    "Sampling profile of the path FM index: 'fast' (denser "
+                                    "suffix array samples; faster locate, larger index), "
+                                    "'default', or 'compact' (sparser samples; smaller index, "
+                                    "slower locate). Non-default profiles are only supported "
+                                    "with the WOTD and FM reads indexes. An existing path "
+                                    "index built with another profile is rejected.",
+                                    seqan2::ArgParseArgument::STRING, "PROFILE" ) );
+  setValidValues( parser, "pindex-sampling", "fast default compact" );
+  setDefaultValue( parser, "pindex-sampling", "default" );
   // index
   addOption( parser,
       seqan2::ArgParseOption( "i", "index",
@@ -402,6 +860,29 @@ setup_argparser( seqan2::ArgumentParser& parser )
         seqan2::ArgParseArgument::STRING, "INDEX" ) );
   setValidValues( parser, "i", "SA ESA WOTD DFI QGRAM FM" );
   setDefaultValue( parser, "i", "WOTD" );
+  // number of threads
+  addOption( parser,
+      seqan2::ArgParseOption( "T", "threads",
+        "Number of worker threads used for finding seeds. Each thread processes one reads "
+        "chunk at a time; if all reads are in one chunk, the starting loci are traversed "
+        "in parallel instead.",
+        seqan2::ArgParseArgument::INTEGER, "INT" ) );
+  setMinValue( parser, "T", "1" );
+  setDefaultValue( parser, "T", 1 );
+  // starting loci index
+  addOption( parser,
+      seqan2::ArgParseOption( "", "loci-index",
+        "Index the k-mers of the starting loci and match them against the reads index "
+        "instead of traversing from each locus. It only supports exact matching and seed "
+        "lengths of at most 32; it is rebuilt on each run using all threads. It takes 16 "
+        "bytes per distinct k-mer spelled from each starting locus (twice that while "
+        "building); the number of k-mers per locus grows with the variant density." ) );
+  // graph snapshot
+  addOption( parser,
+      seqan2::ArgParseOption( "", "graph-snapshot",
+        "Traverse the graph off paths on a compact copy of its node sequences and edges "
+        "indexed by node rank. It takes about three bits per base of the graph plus the "
+        "edges in addition to the graph itself." ) );
   // index only
   addOption( parser,
       seqan2::ArgParseOption( "x", "index-only",
@@ -439,9 +920,11 @@ setup_argparser( seqan2::ArgumentParser& parser )
 get_option_values( Options & options, seqan2::ArgumentParser & parser )
 {
   std::string indexname;
+  std::string samplingname;
 
   getOptionValue( options.fq_path, parser, "fastq" );
   getOptionValue( options.output_path, parser, "output" );
+  options.compact = isSet( parser, "compact" );
   getOptionValue( options.seed_len, parser, "seed-length" );
   getOptionValue( options.chunk_size, parser, "chunk-size" );
   getOptionValue( options.step_size, parser, "step-size" );
@@ -453,10 +936,15 @@ get_option_values( Options & options, seqan2::ArgumentParser & parser )
   getOptionValue( options.dindex_min_ris, parser, "min-insert-size" );
   getOptionValue( options.dindex_max_ris, parser, "max-insert-size" );
   getOptionValue( options.dindex_mode, parser, "dindex-mode" );
+  getOptionValue( options.qgram_len, parser, "qgram-length" );
+  getOptionValue( options.threads, parser, "threads" );
   options.patched = !isSet( parser, "no-patched" );
   getOptionValue( options.pindex_path, parser, "path-index" );
   getOptionValue( indexname, parser, "index" );
+  getOptionValue( samplingname, parser, "pindex-sampling" );
   options.indexonly = isSet( parser, "index-only" );
+  options.loci_index = isSet( parser, "loci-index" );
+  options.graph_snapshot = isSet( parser, "graph-snapshot" );
   getOptionValue( options.log_path, parser, "log-file" );
   options.nologfile = isSet( parser, "no-log-file" );
   options.quiet = isSet( parser, "quiet" );
@@ -466,6 +954,7 @@ get_option_values( Options & options, seqan2::ArgumentParser & parser )
   getArgumentValue( options.rf_path, parser, 0 );
 
   options.index = index_from_str( indexname );
+  options.sampling = sampling_from_str( samplingname );
   if ( options.distance == 0 ) options.distance = options.seed_len;
   if ( options.dindex_max_ris == 0 ) options.dindex_max_ris = options.dindex_min_ris;
 }
@@ -508,6 +997,13 @@ parse_args( Options& options, int argc, char* argv[] )
 
   get_option_values( options, parser );
 
+  if ( options.sampling != SamplingProfile::Default &&
+       options.index != IndexType::Wotd && options.index != IndexType::FM ) {
+    std::cerr << "psikt: path index sampling profile '" << sampling_to_str( options.sampling )
+              << "' is only supported with the WOTD and FM reads indexes." << std::endl;
+    return seqan2::ArgumentParser::PARSE_ERROR;
+  }
+
   return seqan2::ArgumentParser::PARSE_OK;
 }
 
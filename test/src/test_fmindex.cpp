@@ -16,6 +16,9 @@
  */
 
 #include <string>
+#include <algorithm>
+#include <set>
+#include <vector>
 
 #include <psi/fmindex.hpp>
 
@@ -270,6 +273,40 @@ SCENARIO( "Find occurrences of a pattern in a string set using FM-index", "[fmin
   }
 }
 
+TEMPLATE_SCENARIO( "Construct FM-index using multiple threads", "[fmindex]", DiskString, MemString )
+{
+  GIVEN( "Two indexes of the same string set; one constructed using multiple threads" )
+  {
+    typedef seqan2::StringSet< TestType > stringset_type;
+    typedef seqan2::Index< stringset_type, psi::FMIndex<> > index_type;
+
+    stringset_type text;
+    text.push_back( "a-mississippian-lazy-fox-sits-on-a-pie" );
+    text.push_back( "another-brazilian-cute-beaver-builds-a-dam" );
+    text.push_back( "some-african-stupid-chimps-eat-banana" );
+    index_type index1( text );
+    indexRequire( index1, seqan2::FibreSALF() );
+    index_type index2( text );
+    indexRequire( index2, seqan2::FibreSALF(), 4 );
+
+    auto occurrences = []( index_type& index, std::string const& pattern ) {
+      seqan2::Finder< index_type > finder( index );
+      std::vector< index_type::pos_type > occs;
+      while ( find( finder, pattern ) ) occs.push_back( beginPosition( finder ) );
+      std::sort( occs.begin(), occs.end() );
+      return occs;
+    };
+
+    THEN( "They should find the same occurrences of any pattern" )
+    {
+      for ( std::string pattern : { "a", "an", "ana", "si", "-a-", "i", "zy-f", "ox" } ) {
+        REQUIRE( occurrences( index1, pattern ) == occurrences( index2, pattern ) );
+      }
+      REQUIRE( length( index2 ) == length( index1 ) );
+    }
+  }
+}
+
 SCENARIO( "Save and load FM-index on string", "[fmindex]" )
 {
   GIVEN( "An index based on a disk-based string serialized to the disk" )
@@ -1373,3 +1410,187 @@ TEMPLATE_SCENARIO( "Traverse prefix tree of a string set using FM-index index it
     }
   }
 }
+
+SCENARIO( "Jump to q-grams using the q-gram table of FM-index", "[fmindex][iterator]" )
+{
+  GIVEN( "An FM-index of a string set with a q-gram table" )
+  {
+    typedef seqan2::StringSet< MemString > stringset_type;
+    typedef seqan2::Index< stringset_type, psi::FMIndex<> > index_type;
+    typedef typename seqan2::Iterator< index_type, seqan2::TopDown<> >::Type iterator_type;
+
+    const char alphabet[] = { 'A', 'C', 'G', 'T' };
+    unsigned int q = 3;
+    stringset_type text;
+    text.push_back( "GATAGACTAGCCANTTAGC" );
+    text.push_back( "GGGCGTAGCCAGATTACA" );
+    index_type index( text );
+    indexRequire( index, seqan2::FibreSALF() );
+    index.create_qgram_table( q );
+
+    auto check = [&]( index_type const& idx ) {
+      bool matched = true;
+      for ( uint64_t code = 0; code < ( 1u << ( 2 * q ) ); ++code ) {
+        iterator_type it1( idx );
+        iterator_type it2( idx );
+        bool found = true;
+        for ( unsigned int i = q; i > 0 && found; --i ) {
+          found = goDown( it2, alphabet[ ( code >> ( 2 * ( i - 1 ) ) ) & 3 ] );
+        }
+        bool jumped = it1.go_down_qgram( code ) != 0;
+        if ( jumped != found ) matched = false;
+        if ( found && ( it1.range() != it2.range() || repLength( it1 ) != q ) ) matched = false;
+      }
+      return matched;
+    };
+
+    THEN( "Jumping to any q-gram should be the same as going down along it" )
+    {
+      REQUIRE( index.get_qgram_table().get_q() == q );
+      REQUIRE( check( index ) );
+    }
+
+    WHEN( "The q-gram table is built using multiple threads" )
+    {
+      unsigned int ql = 6;
+      index.create_qgram_table( ql );
+      std::vector< QGramTable::range_type > truth;
+      for ( uint64_t code = 0; code < ( 1u << ( 2 * ql ) ); ++code ) {
+        truth.push_back( index.get_qgram_table().range( code ) );
+      }
+
+      THEN( "It should be identical to the one built by a single thread" )
+      {
+        for ( unsigned int nof_threads : { 2, 3, 4, 16 } ) {
+          index.create_qgram_table( ql, nof_threads );
+          REQUIRE( index.get_qgram_table().get_q() == ql );
+          bool matched = true;
+          for ( uint64_t code = 0; code < ( 1u << ( 2 * ql ) ); ++code ) {
+            if ( index.get_qgram_table().range( code ) != truth[ code ] ) matched = false;
+          }
+          REQUIRE( matched );
+        }
+      }
+    }
+
+    WHEN( "It is saved and loaded" )
+    {
+      std::string fpath = SEQAN_TEMP_FILENAME();
+      save( index, fpath );
+      index_type index2;
+      open( index2, fpath );
+
+      THEN( "The q-gram table should be loaded as well" )
+      {
+        REQUIRE( index2.get_qgram_table().get_q() == q );
+        REQUIRE( check( index2 ) );
+      }
+    }
+  }
+}
+
+SCENARIO( "Record the sampling profile of FM-index in the index file", "[fmindex]" )
+{
+  GIVEN( "An FM-index of a string with a non-default sampling profile saved to the disk" )
+  {
+    typedef YaString< InMemory > string_type;
+    typedef seqan2::Index< string_type, psi::CompactFMIndex > index_type;
+
+    string_type text( "a-mississippian-lazy-fox-sits-on-a-pie" );
+    index_type index1( text );
+    indexRequire( index1, seqan2::FibreSALF() );
+    std::string fpath = SEQAN_TEMP_FILENAME();
+    save( index1, fpath );
+
+    WHEN( "It is opened by an index with the same profile" )
+    {
+      index_type index2;
+      bool opened = open( index2, fpath );
+
+      THEN( "It should be loaded and locate all occurrences" )
+      {
+        REQUIRE( opened );
+        REQUIRE( length( index2 ) == length( index1 ) );
+        seqan2::Finder< index_type > finder( index2 );
+        std::set< index_type::savalue_type > true_occs = { 11, 35 };
+        std::set< index_type::savalue_type > occs;
+        while ( find( finder, "pi" ) ) occs.insert( beginPosition( finder ) );
+        REQUIRE( occs == true_occs );
+      }
+    }
+
+    WHEN( "It is opened by an index with another profile" )
+    {
+      seqan2::Index< string_type, psi::FastFMIndex > index2;
+      seqan2::Index< string_type, psi::FMIndex<> > index3;
+
+      THEN( "It should be rejected with an error" )
+      {
+        REQUIRE_THROWS_AS( open( index2, fpath ), std::runtime_error );
+        REQUIRE( index2.empty() );
+        REQUIRE_THROWS_AS( open( index3, fpath ), std::runtime_error );
+        REQUIRE( index3.empty() );
+      }
+    }
+  }
+}
+
+TEMPLATE_SCENARIO( "Locate occurrences of FM-index iterator in batch", "[fmindex][iterator]",
+                   ( psi::FMIndex<> ), ( psi::FastFMIndex ), ( psi::CompactFMIndex ) )
+{
+  GIVEN( "An FM-index of a repetitive string set" )
+  {
+    typedef seqan2::StringSet< MemString > stringset_type;
+    typedef seqan2::Index< stringset_type, TestType > index_type;
+    typedef typename seqan2::Iterator< index_type, seqan2::TopDown<> >::Type iterator_type;
+    typedef typename iterator_type::occs_type occs_type;
+
+    const char alphabet[] = { 'A', 'C', 'G', 'T' };
+    stringset_type text;
+    std::string unit = "GATTACAGGTACCANTTAGCA";
+    for ( unsigned int i = 0; i < 12; ++i ) {
+      std::string str;
+      for ( unsigned int j = 0; j <= i; ++j ) str += unit.substr( j % unit.size() ) + unit;
+      text.push_back( str );
+    }
+    index_type index( text );
+    indexRequire( index, seqan2::FibreSALF() );
+
+    WHEN( "All occurrences of short patterns are located in batch" )
+    {
+      bool matched = true;
+      bool matched_cb = true;
+      std::size_t max_occs = 0;
+      occs_type occs;
+      for ( unsigned int len = 1; len <= 3; ++len ) {
+        for ( uint64_t code = 0; code < ( 1u << ( 2 * len ) ); ++code ) {
+          iterator_type it( index );
+          bool found = true;
+          for ( unsigned int i = len; i > 0 && found; --i ) {
+            found = goDown( it, alphabet[ ( code >> ( 2 * ( i - 1 ) ) ) & 3 ] );
+          }
+          if ( !found ) continue;
+          it.get_occurrences( occs );
+          if ( occs.size() != countOccurrences( it ) ) matched = false;
+          max_occs = std::max< std::size_t >( max_occs, occs.size() );
+          for ( std::size_t i = 0; i < occs.size() && matched; ++i ) {
+            if ( occs[ i ] != it.get_position( i ) ) matched = false;
+          }
+          std::size_t i = 0;
+          it.for_each_occurrence( [&]( auto const& pos ) {
+              if ( i >= occs.size() || pos != occs[ i ] ) matched_cb = false;
+              ++i;
+            } );
+          if ( i != occs.size() ) matched_cb = false;
+        }
+      }
+
+      THEN( "They should be the same as locating each occurrence independently" )
+      {
+        REQUIRE( max_occs > 64 );
+        REQUIRE( matched );
+        REQUIRE( matched_cb );
+      }
+    }
+  }
+}
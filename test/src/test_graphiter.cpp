@@ -28,6 +28,7 @@
 #include <gum/io_utils.hpp>
 #include <psi/graph.hpp>
 #include <psi/graph_iter.hpp>
+#include <psi/graph_snapshot.hpp>
 #include <psi/pathindex.hpp>
 
 #include "vg/vg.pb.h"
@@ -416,6 +417,81 @@ SCENARIO( "Traverse a sequence graph using backtracking algorithm", "[graph][ite
   }
 }
 
+SCENARIO( "Traverse a snapshot of a sequence graph", "[graph][snapshot]" )
+{
+  typedef gum::SeqGraph< gum::Dynamic > graph_type;
+  typedef graph_type::id_type id_type;
+  typedef graph_type::rank_type rank_type;
+  typedef graph_type::linktype_type linktype_type;
+
+  GIVEN( "A small variation graph and its snapshot" )
+  {
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::extend( graph, vgpath, vg_loader, true );
+    GraphSnapshot< graph_type > snapshot( graph );
+
+    THEN( "It should have the same node sequences and out-edges as the graph" )
+    {
+      REQUIRE( snapshot.get_node_count() == graph.get_node_count() );
+      REQUIRE( snapshot.get_edge_count() == graph.get_edge_count() );
+      graph.for_each_node(
+          [&]( rank_type, id_type id ) {
+            auto sequence = graph.node_sequence( id );
+            auto const& view = snapshot.node_sequence( id );
+            REQUIRE( view.size() == sequence.size() );
+            REQUIRE( snapshot.node_length( id ) == graph.node_length( id ) );
+            for ( std::size_t i = 0; i < sequence.size(); ++i ) {
+              REQUIRE( view[ i ] == sequence[ i ] );
+            }
+            std::vector< id_type > expected;
+            std::vector< id_type > adjs;
+            graph.for_each_edges_out(
+                id, [&expected]( id_type to, linktype_type ) {
+                  expected.push_back( to );
+                  return true;
+                } );
+            snapshot.for_each_edges_out(
+                id, [&adjs]( id_type to, linktype_type ) {
+                  adjs.push_back( to );
+                  return true;
+                } );
+            REQUIRE( adjs == expected );
+            REQUIRE( snapshot.outdegree( id ) == graph.outdegree( id ) );
+            REQUIRE( snapshot.has_edges_out( id ) == graph.has_edges_out( id ) );
+            return true;
+          } );
+    }
+
+    THEN( "Its rank view should step through the nodes by their ranks" )
+    {
+      auto view = snapshot.rank_view();
+      graph.for_each_node(
+          [&]( rank_type rank, id_type id ) {
+            REQUIRE( node_handle( view, id ) == rank );
+            REQUIRE( node_handle( graph, id ) == id );
+            REQUIRE( snapshot.rank_to_id( rank ) == id );
+            REQUIRE( view.node_length( rank ) == graph.node_length( id ) );
+            REQUIRE( view.outdegree( rank ) == graph.outdegree( id ) );
+            std::vector< id_type > expected;
+            std::vector< id_type > adjs;
+            graph.for_each_edges_out(
+                id, [&expected]( id_type to, linktype_type ) {
+                  expected.push_back( to );
+                  return true;
+                } );
+            view.for_each_edges_out(
+                rank, [&]( rank_type to, linktype_type ) {
+                  adjs.push_back( graph.rank_to_id( to ) );
+                  return true;
+                } );
+            REQUIRE( adjs == expected );
+            return true;
+          } );
+    }
+  }
+}
+
 SCENARIO( "Sequence graph breadth-first traverse (BFS)", "[graph][iterator][bfs]" )
 {
   typedef gum::SeqGraph< gum::Dynamic > graph_type;
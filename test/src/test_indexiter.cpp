@@ -16,6 +16,9 @@
  */
 
 #include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
 #include <functional>
 
 #include <psi/sequence.hpp>
@@ -285,6 +288,45 @@ TEMPLATE_SCENARIO( "Find k-mer exact matches between two texts using top-down in
           REQUIRE( seeds3.size() == 8 );
         }
       }
+
+      AND_WHEN( "Enumerate all k-mers of both indices using multiple threads" )
+      {
+        auto to_tuple = []( Seed<> const& hit ) {
+          return std::make_tuple( hit.node_id, hit.node_offset, hit.read_id, hit.read_offset );
+        };
+
+        kmer_exact_matches( itr1, itr2, &rec1.str, &rec2, 10, callback );
+        std::vector< decltype( to_tuple( seeds.front() ) ) > truth;
+        for ( auto const& hit : seeds ) truth.push_back( to_tuple( hit ) );
+        std::sort( truth.begin(), truth.end() );
+
+        create_index( index1 );
+        create_index( index2 );
+        for ( unsigned int nof_threads : { 2, 3 } ) {
+          for ( unsigned int plen : { 0, 1, 9 } ) {
+            std::vector< std::vector< Seed<> > > tseeds( nof_threads );
+            std::vector< std::function< void(const Seed<>&) > > callbacks;
+            std::vector< std::function< void( std::size_t, bool ) > > collectors;
+            for ( unsigned int i = 0; i < nof_threads; ++i ) {
+              callbacks.push_back( [&tseeds, i]( const Seed<>& hit ) { tseeds[ i ].push_back( hit ); } );
+              collectors.push_back( []( std::size_t, bool ) { } );
+            }
+            kmer_exact_matches( index1, index2, &rec1.str, &rec2, 10, callbacks, 0, collectors,
+                                plen );
+            decltype( truth ) hits;
+            for ( auto const& ts : tseeds ) {
+              for ( auto const& hit : ts ) hits.push_back( to_tuple( hit ) );
+            }
+            std::sort( hits.begin(), hits.end() );
+
+            THEN( "They found the same 10-mer exact matches as the single-threaded enumeration" )
+            {
+              REQUIRE( truth.size() == 8 );
+              REQUIRE( hits == truth );
+            }
+          }
+        }
+      }
     }
   }
 
@@ -400,3 +442,116 @@ TEMPLATE_SCENARIO( "Find k-mer exact matches between two texts using top-down in
     }
   }
 }
+
+SCENARIO( "Go down a group of FM-index iterators by one character each", "[index][iterator]" )
+{
+  GIVEN( "An FM-index on a string set and a group of iterators" )
+  {
+    typedef seqan2::StringSet< MemString > stringset_type;
+    typedef seqan2::Index< stringset_type, psi::FMIndex<> > index_type;
+    typedef TFineIndexIter< index_type, seqan2::ParentLinks<> > iterator_type;
+
+    stringset_type text;
+    text.push_back( "GATAGACTAGCCA" );
+    text.push_back( "GGGCGTAGCCAGATTACA" );
+    index_type index( text );
+    indexRequire( index, seqan2::FibreSALF() );
+
+    std::vector< std::string > patterns =
+      { "AG", "GATT", "CCA", "TTTT", "GC", "A", "TAGC", "CAGA", "ACG", "GGGCGTAGCCAGA",
+        "AGCCAG", "TA", "GA", "C", "G", "T", "ATT", "CTA", "GCGT", "AGATTACA" };
+    std::size_t n = patterns.size();
+    std::vector< iterator_type > batch( n, iterator_type( index ) );
+    std::vector< iterator_type > single( n, iterator_type( index ) );
+
+    WHEN( "They go down along different patterns in batches" )
+    {
+      std::vector< iterator_type* > iters;
+      std::vector< char > chars;
+      std::vector< unsigned char > found;
+      std::vector< std::size_t > alive( n );
+      for ( std::size_t i = 0; i < n; ++i ) alive[ i ] = i;
+      for ( std::size_t depth = 0; depth < 13; ++depth ) {
+        iters.clear();
+        chars.clear();
+        for ( auto i : alive ) {
+          iters.push_back( &batch[ i ] );
+          chars.push_back( patterns[ i ][ depth % patterns[ i ].size() ] );
+        }
+        found.resize( alive.size() );
+        go_down_batch( iters.data(), chars.data(), found.data(), alive.size() );
+        std::size_t nofalive = 0;
+        for ( std::size_t j = 0; j < alive.size(); ++j ) {
+          bool down = go_down( single[ alive[ j ] ], chars[ j ] );
+          REQUIRE( static_cast< bool >( found[ j ] ) == down );
+          if ( down ) alive[ nofalive++ ] = alive[ j ];
+        }
+        alive.resize( nofalive );
+      }
+
+      THEN( "They should end up where going down one by one does" )
+      {
+        for ( std::size_t i = 0; i < n; ++i ) {
+          REQUIRE( rep_length( batch[ i ] ) == rep_length( single[ i ] ) );
+          REQUIRE( count_occurrences( batch[ i ] ) == count_occurrences( single[ i ] ) );
+        }
+      }
+    }
+  }
+}
+
+SCENARIO( "Find super-maximal exact matches using a bidirectional index", "[index][iterator]" )
+{
+  GIVEN( "A bidirectional FM index of a small set of texts" )
+  {
+    std::vector< std::string > texts = { "ACGTTGCATGCACGT", "TTGCAACGGTACGAT", "CATGCAGGTTACAGT" };
+    seqan2::StringSet< seqan2::Dna5String > str;
+    for ( auto const& t : texts ) appendValue( str, t );
+    seqan2::Index< seqan2::StringSet< seqan2::Dna5String >, CBiFMIndex > index( str );
+    create_index( index );
+
+    auto occurs =
+        [&texts]( std::string const& s ) {
+          return std::any_of( texts.begin(), texts.end(),
+                              [&s]( auto const& t ) { return t.find( s ) != std::string::npos; } );
+        };
+    /* All matches [i, j) not contained in any other match. */
+    auto naive_smems =
+        [&occurs]( std::string const& p, unsigned int minlen ) {
+          std::vector< std::pair< unsigned int, unsigned int > > mems;
+          for ( unsigned int i = 0; i < p.size(); ++i ) {
+            unsigned int j = i;
+            while ( j < p.size() && p[ j ] != 'N' && occurs( p.substr( i, j - i + 1 ) ) ) ++j;
+            if ( j == i ) continue;
+            if ( i != 0 && p[ i - 1 ] != 'N' && occurs( p.substr( i - 1, j - i + 1 ) ) ) continue;
+            if ( !mems.empty() && mems.back().second >= j ) continue;
+            mems.emplace_back( i, j );
+          }
+          std::vector< std::pair< unsigned int, unsigned int > > result;
+          for ( auto const& m : mems ) if ( m.second - m.first >= minlen ) result.push_back( m );
+          return result;
+        };
+
+    std::vector< std::string > patterns = { "ACGTTGCAACGGTACAGTT", "GGGGCATGCAGG", "TTGCANACGTTGCATGC",
+                                            "CAGTTACGATGCACGTTGCA", "NNACGN", "GCATGCACGTACGATCATG" };
+
+    for ( unsigned int minlen : { 1u, 3u, 6u } ) {
+      WHEN( "Finding SMEMs of length at least " + std::to_string( minlen ) )
+      {
+        THEN( "All SMEMs should be reported exactly once" )
+        {
+          for ( auto const& p : patterns ) {
+            std::vector< std::pair< unsigned int, unsigned int > > found;
+            find_smems( p, index, minlen,
+                        [&]( auto const& mem ) {
+                          REQUIRE( countOccurrences( mem.iter ) > 0 );
+                          found.emplace_back( mem.begin, mem.end );
+                        } );
+            std::sort( found.begin(), found.end() );
+            REQUIRE( found == naive_smems( p, minlen ) );
+          }
+        }
+      }
+    }
+  }
+}
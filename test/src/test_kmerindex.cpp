@@ -0,0 +1,113 @@
+/**
+ *    @file  test_kmerindex.cpp
+ *   @brief  Test k-mer index module.
+ *
+ *  Test scenarios for sorted packed k-mer array index in psi.
+ *
+ *  @author  Ali Ghaffaari (\@cartoonist), <ali.ghaffaari@mpi-inf.mpg.de>
+ *
+ *  @internal
+ *       Created:  Fri Oct 16, 2026  11:40
+ *  Organization:  Max-Planck-Institut fuer Informatik
+ *     Copyright:  Copyright (c) 2026, Ali Ghaffaari
+ *
+ *  This source code is released under the terms of the MIT License.
+ *  See LICENSE file for more information.
+ */
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <psi/sequence.hpp>
+#include <psi/index.hpp>
+#include <psi/index_iter.hpp>
+
+#include "test_base.hpp"
+
+
+using namespace psi;
+
+SCENARIO( "Traverse a k-mer index of fixed-length strings", "[kmerindex]" )
+{
+  typedef seqan2::Index< Dna5QStringSet<>, KmerIndex<> > index_type;
+  typedef TFineIndexIter< index_type, seqan2::ParentLinks<> > iter_type;
+
+  GIVEN( "A set of strings of the same length" )
+  {
+    std::vector< std::string > strs = { "GATTACA", "CATTACA", "GATTACA", "GATNACA", "AAAAAAA",
+                                        "TTTTTTT", "GATTAGA", "CATTACA", "ACGTACG", "GATTACA" };
+    Dna5QStringSet<> text;
+    for ( auto const& s : strs ) appendValue( text, s );
+    index_type index( text );
+
+    auto ids_with_prefix = [&strs]( std::string const& prefix ) {
+      std::vector< std::size_t > ids;
+      for ( std::size_t i = 0; i < strs.size(); ++i ) {
+        if ( strs[ i ].find( 'N' ) != std::string::npos ) continue;
+        if ( strs[ i ].compare( 0, prefix.size(), prefix ) == 0 ) ids.push_back( i );
+      }
+      return ids;
+    };
+
+    THEN( "The distinct k-mers should be indexed except those having N" )
+    {
+      REQUIRE( index.get_k() == 7 );
+      REQUIRE( index.size() == 6 );
+    }
+
+    WHEN( "Going down along the prefixes of the strings and some absent patterns" )
+    {
+      std::vector< std::string > patterns = strs;
+      patterns.push_back( "GATTCCA" );
+      patterns.push_back( "TTTTTTA" );
+      patterns.push_back( "CCCCCCC" );
+
+      THEN( "The iterator should narrow down to the strings having the prefix" )
+      {
+        for ( auto const& p : patterns ) {
+          iter_type itr( index );
+          std::vector< std::size_t > counts( 1, count_occurrences( itr ) );
+          unsigned int depth = 0;
+          for ( ; depth < p.size(); ++depth ) {
+            auto truth = ids_with_prefix( p.substr( 0, depth + 1 ) );
+            bool found = go_down( itr, p[ depth ] );
+            REQUIRE( found == !truth.empty() );
+            if ( !found ) break;
+            REQUIRE( rep_length( itr ) == depth + 1 );
+            REQUIRE( count_occurrences( itr ) == truth.size() );
+            std::vector< std::size_t > ids;
+            for_each_occurrence( itr, [&ids]( auto const& occ ) {
+                REQUIRE( occ.i2 == 0 );
+                ids.push_back( occ.i1 );
+              } );
+            std::sort( ids.begin(), ids.end() );
+            REQUIRE( ids == truth );
+            counts.push_back( truth.size() );
+          }
+          if ( depth == p.size() ) REQUIRE( !go_down( itr, 'A' ) );
+          while ( depth-- > 0 ) {
+            REQUIRE( go_up( itr ) );
+            REQUIRE( rep_length( itr ) == depth );
+            REQUIRE( count_occurrences( itr ) == counts[ depth ] );
+          }
+          REQUIRE( is_root( itr ) );
+          REQUIRE( !go_up( itr ) );
+        }
+      }
+    }
+  }
+
+  GIVEN( "A set of strings of different lengths" )
+  {
+    Dna5QStringSet<> text;
+    appendValue( text, "GATTACA" );
+    appendValue( text, "GATTAC" );
+
+    THEN( "Building the index should fail" )
+    {
+      REQUIRE_THROWS_AS( index_type( text ), std::runtime_error );
+    }
+  }
+}
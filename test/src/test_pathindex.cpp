@@ -169,6 +169,28 @@ SCENARIO( "String set of PathIndex with non-zero context", "[pathindex]" )
       }
     }
 
+    WHEN( "A set of paths are added to a PathIndex in lazy mode and indexed using multiple threads" )
+    {
+      uint64_t context = 10;
+      Dna5QPathIndex< graph_type, TIndexSpec, Forward > pindex( graph, context, true );
+      Path< graph_type > path( &graph, { 205, 207, 209, 210 }, context-1, context-1 );
+      pindex.add_path( ( path ) );
+      path = Path< graph_type >( &graph, { 187, 189, 191, 193, 194, 195, 197 }, context-1, context-1 );
+      pindex.add_path( ( path ) );
+      path = Path< graph_type >( &graph, { 167, 168, 171, 172, 174 }, context-1, context-1 );
+      pindex.add_path( ( path ) );
+
+      pindex.create_index( 2 );
+
+      THEN( "The paths sequence set should be in the same order as the paths" )
+      {
+        REQUIRE( length( indexText( pindex.index ) ) == 3 );
+        REQUIRE( indexText( pindex.index )[0] == "GTTTCCTGTACTAAGGACAAAGGTGCGGGGAGATAA" );
+        REQUIRE( indexText( pindex.index )[1] == "CAAGGGCTTTTAA" );
+        REQUIRE( indexText( pindex.index )[2] == "CATTTGTCTTATTGTCCAGGA" );
+      }
+    }
+
     WHEN( "A set of paths are added to a PathIndex with non-zero context in Forward direction" )
     {
       uint64_t context = 10;
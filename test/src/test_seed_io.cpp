@@ -0,0 +1,144 @@
+/**
+ *    @file  test_seed_io.cpp
+ *   @brief  Test seed I/O module.
+ *
+ *  This test contains test scenarios for seed writer and reader classes.
+ *
+ *  @author  Ali Ghaffaari (\@cartoonist), <ali.ghaffaari@mpi-inf.mpg.de>
+ *
+ *  @internal
+ *       Created:  Thu Oct 15, 2026  10:12
+ *  Organization:  Max-Planck-Institut fuer Informatik
+ *     Copyright:  Copyright (c) 2026, Ali Ghaffaari
+ *
+ *  This source code is released under the terms of the MIT License.
+ *  See LICENSE file for more information.
+ */
+
+#include <sstream>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
+#include <psi/seed_io.hpp>
+
+#include "test_base.hpp"
+
+
+using namespace psi;
+
+namespace {
+  inline std::vector< Seed<> >
+  random_seeds( std::size_t n )
+  {
+    std::vector< Seed<> > seeds;
+    auto& rgn = rnd::get_rgn();
+    std::uniform_int_distribution< std::size_t > ids( 1, 100000 );
+    std::uniform_int_distribution< std::size_t > offsets( 0, 1024 );
+    for ( std::size_t i = 0; i < n; ++i ) {
+      Seed<> hit;
+      hit.node_id = ids( rgn );
+      hit.node_offset = offsets( rgn );
+      hit.read_id = ids( rgn ) % 500;
+      hit.read_offset = offsets( rgn ) % 150;
+      seeds.push_back( hit );
+    }
+    return seeds;
+  }
+
+  inline auto
+  as_tuple( Seed<> const& hit )
+  {
+    return std::make_tuple( hit.read_id, hit.read_offset, hit.node_id, hit.node_offset );
+  }
+
+  inline bool
+  seed_less( Seed<> const& a, Seed<> const& b )
+  {
+    return as_tuple( a ) < as_tuple( b );
+  }
+
+  template< typename TLayout >
+  inline std::vector< Seed<> >
+  roundtrip( std::vector< Seed<> > const& seeds, std::size_t bufsize )
+  {
+    std::stringstream ss;
+    {
+      SeedWriter< TLayout > writer( ss, bufsize );
+      for ( auto const& hit : seeds ) writer( hit );
+      REQUIRE( writer.get_nof_seeds() == seeds.size() );
+    }
+    std::vector< Seed<> > result;
+    SeedReader< TLayout > reader( ss, bufsize );
+    reader.for_each( [&result]( Seed<> const& hit ) { result.push_back( hit ); } );
+    return result;
+  }
+}
+
+SCENARIO( "Write and read seeds in plain layout", "[seedio]" )
+{
+  GIVEN( "A set of random seed hits" )
+  {
+    rnd::set_seed( 7 );
+    auto seeds = random_seeds( 5000 );
+
+    WHEN( "They are written by a small buffer and read back" )
+    {
+      auto result = roundtrip< PlainLayout >( seeds, 256 );
+
+      THEN( "The same hits should be read in the same order" )
+      {
+        REQUIRE( result.size() == seeds.size() );
+        REQUIRE( std::equal( result.begin(), result.end(), seeds.begin(),
+                             []( auto const& a, auto const& b ) {
+                               return as_tuple( a ) == as_tuple( b );
+                             } ) );
+      }
+    }
+  }
+}
+
+SCENARIO( "Write and read seeds in compact layout", "[seedio]" )
+{
+  GIVEN( "A set of random seed hits" )
+  {
+    rnd::set_seed( 11 );
+    auto seeds = random_seeds( 5000 );
+
+    WHEN( "They are written by a small buffer and read back" )
+    {
+      auto result = roundtrip< CompactLayout >( seeds, 1024 );
+
+      THEN( "The same hits should be read sorted by read id and offset in each block" )
+      {
+        REQUIRE( result.size() == seeds.size() );
+        std::sort( seeds.begin(), seeds.end(), seed_less );
+        std::sort( result.begin(), result.end(), seed_less );
+        REQUIRE( std::equal( result.begin(), result.end(), seeds.begin(),
+                             []( auto const& a, auto const& b ) {
+                               return as_tuple( a ) == as_tuple( b );
+                             } ) );
+      }
+    }
+
+    WHEN( "No hit is written" )
+    {
+      auto result = roundtrip< CompactLayout >( {}, 1024 );
+
+      THEN( "No hit should be read" )
+      {
+        REQUIRE( result.empty() );
+      }
+    }
+  }
+
+  GIVEN( "An input stream with an invalid header" )
+  {
+    std::stringstream ss( "NOTSEEDS" );
+
+    THEN( "Opening it should throw" )
+    {
+      REQUIRE_THROWS_AS( SeedReader< CompactLayout >( ss ), std::runtime_error );
+    }
+  }
+}
@@ -18,12 +18,17 @@
 #include <fstream>
 #include <string>
 #include <utility>
+#include <vector>
+#include <tuple>
+#include <mutex>
+#include <algorithm>
 
 #include <gum/graph.hpp>
 #include <gum/io_utils.hpp>
 #include <psi/seed_finder.hpp>
 #include <psi/traverser.hpp>
 #include <psi/utils.hpp>
+#include <seqan/seq_io.h>
 
 #include "vg/vg.pb.h"
 #include "vg/stream.hpp"
@@ -212,6 +217,75 @@ SCENARIO( "Load and save starting loci", "[seedfinder]" )
   }
 }
 
+SCENARIO( "Load path index components concurrently with the graph", "[seedfinder]" )
+{
+  GIVEN ( "A path index of a tiny variation graph saved to disk" )
+  {
+    typedef gum::SeqGraph< gum::Succinct > graph_type;
+    typedef SeedFinderTraits< gum::Succinct, Dna5QStringSet<>, seqan2::IndexEsa<>, InMemory > finder_traits_type;
+    typedef SeedFinder< NoStats, finder_traits_type > finder_type;
+
+    finder_type::set_kokkos_handling_status( false );
+
+    std::string vgpath = test_data_dir + "/tiny/tiny.vg";
+    graph_type graph;
+    gum::util::load( graph, vgpath, vg_loader, true );
+
+    unsigned int dmin = 8;
+    unsigned int dmax = 12;
+    unsigned int seedlen = 30;
+    finder_type finder( graph, seedlen );
+    finder.unset_as_finaliser();
+    finder.create_path_index( 2, false, 0, 1, dmin, dmax, PerComponent{} );
+    std::string prefix = get_tmpfile();
+    REQUIRE( finder.serialize_path_index( prefix, 1 ) );
+
+    WHEN( "It is loaded by another finder while loading the graph" )
+    {
+      graph_type graph2;
+      finder_type finder2( graph2, seedlen );
+      finder2.unset_as_finaliser();
+      bool graph_loaded = false;
+      bool loaded = finder2.load_path_index( prefix, 0, 1, dmin, dmax,
+                                             [&]( ) {
+                                               gum::util::load( graph2, vgpath, vg_loader, true );
+                                               graph_loaded = true;
+                                             } );
+
+      THEN( "All components should be loaded as they were" )
+      {
+        REQUIRE( loaded );
+        REQUIRE( graph_loaded );
+        REQUIRE( finder2.get_pindex().size() == finder.get_pindex().size() );
+        REQUIRE( finder2.get_starting_loci().size() == finder.get_starting_loci().size() );
+        for ( std::size_t i = 0; i < finder.get_starting_loci().size(); ++i ) {
+          REQUIRE( finder2.get_starting_loci()[ i ].node_id() == finder.get_starting_loci()[ i ].node_id() );
+          REQUIRE( finder2.get_starting_loci()[ i ].offset() == finder.get_starting_loci()[ i ].offset() );
+        }
+        auto ibyc = [&graph2]( auto cid ) { return graph2.id_by_coordinate( cid ); };
+        REQUIRE( finder2.verify_distance( ibyc( 1 ), 0, ibyc( 2 ), 0 ) );
+        REQUIRE( !finder2.verify_distance( ibyc( 1 ), 0, ibyc( 7 ), 0 ) );
+      }
+    }
+
+    WHEN( "Loading the graph fails" )
+    {
+      graph_type graph2;
+      finder_type finder2( graph2, seedlen );
+      finder2.unset_as_finaliser();
+
+      THEN( "The error should be propagated to the caller" )
+      {
+        REQUIRE_THROWS_AS( finder2.load_path_index( prefix, 0, 1, dmin, dmax,
+                                                    []( ) {
+                                                      throw std::runtime_error( "failed" );
+                                                    } ),
+                           std::runtime_error );
+      }
+    }
+  }
+}
+
 SCENARIO( "Distance constraints verification", "[seedfinder]" )
 {
   GIVEN ( "A tiny variation graph" )
@@ -288,6 +362,27 @@ SCENARIO( "Distance constraints verification", "[seedfinder]" )
         }
       }
 
+      THEN( "It should give the same results when verifying all pairs in a batch" )
+      {
+        std::vector< ends_type > queries;
+        for ( std::size_t i = 0; i < std::max( distant.size(), closed.size() ); ++i ) {
+          if ( i < closed.size() ) queries.push_back( closed[ i ] );
+          if ( i < distant.size() ) queries.push_back( distant[ i ] );
+        }
+        sdsl::bit_vector result;
+        finder.verify_distances( queries, result );
+        REQUIRE( result.size() == queries.size() );
+        for ( std::size_t i = 0; i < queries.size(); ++i ) {
+          auto const& ends = queries[ i ];
+          REQUIRE( result[ i ] == finder.verify_distance( std::get<0>( ends ), std::get<1>( ends ),
+                                                          std::get<2>( ends ), std::get<3>( ends ) ) );
+        }
+        REQUIRE( sdsl::util::cnt_one_bits( result ) == closed.size() );
+
+        finder.verify_distances( std::vector< ends_type >{}, result );
+        REQUIRE( result.size() == 0 );
+      }
+
       AND_WHEN( "The index is loaded from disk" )
       {
         std::string prefix = get_tmpfile();
@@ -414,5 +509,380 @@ SCENARIO( "Distance constraints verification", "[seedfinder]" )
         }
       }
     }
+
+    WHEN( "Creating distance index using multiple threads with a tight memory limit" )
+    {
+      finder.create_distance_index( dmin, dmax, PerComponent{}, nullptr, nullptr, 4, 1 );
+      finder_type finder2( graph, seedlen );
+      finder2.unset_as_finaliser();
+      finder2.create_distance_index( dmin, dmax, PerComponent{} );
+
+      THEN( "It should be identical to the one built by one thread" )
+      {
+        auto const& dindex = finder.get_distance_matrix();
+        auto const& dindex2 = finder2.get_distance_matrix();
+        REQUIRE( dindex.numRows() == dindex2.numRows() );
+        REQUIRE( dindex.nnz() == dindex2.nnz() );
+        for ( auto ends : distant ) {
+          REQUIRE( !finder.verify_distance( std::get<0>( ends ), std::get<1>( ends ),
+                                            std::get<2>( ends ), std::get<3>( ends ) ) );
+        }
+        for ( auto ends : closed ) {
+          REQUIRE( finder.verify_distance( std::get<0>( ends ), std::get<1>( ends ),
+                                           std::get<2>( ends ), std::get<3>( ends ) ) );
+        }
+      }
+    }
+  }
+}
+
+SCENARIO( "Find seeds on paths using the q-gram table of the path index", "[seedfinder]" )
+{
+  GIVEN ( "An FM path index of a small variation graph and a set of reads" )
+  {
+    typedef gum::SeqGraph< gum::Dynamic > graph_type;
+    typedef PathIndex< graph_type, MemString, psi::FMIndex<>, Reversed > pathindex_type;
+    typedef Records< Dna5QStringSet<> > readsrecord_type;
+    typedef seqan2::Index< Dna5QStringSet<>, seqan2::IndexWotd<> > readsindex_type;
+    typedef std::tuple< std::size_t, std::size_t, std::size_t, std::size_t > hit_type;
+
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::extend( graph, vgpath, vg_loader );
+
+    pathindex_type pindex( graph );
+    for ( unsigned int i = 0; i < 3; ++i ) {
+      Path< graph_type > path( &graph );
+      for ( graph_type::id_type j = 3+i; j <= 210; j+=(i+1)*4 ) add_node( path, j );
+      pindex.add_path( std::move( path ) );
+    }
+    pindex.create_index();
+
+    std::string readspath = test_data_dir + "/small/reads_n10l10e0i0.fastq";
+    seqan2::SeqFileIn reads_file;
+    if ( !open( reads_file, readspath.c_str() ) ) {
+      throw std::runtime_error( "cannot open file " + readspath );
+    }
+    readsrecord_type reads;
+    readRecords( reads, reads_file, 10 );
+    readsindex_type reads_index( reads.str );
+    create_index( reads_index );
+
+    unsigned int k = 8;
+    auto to_tuple = []( Seed<> const& hit ) {
+      return std::make_tuple( hit.node_id, hit.node_offset, hit.read_id, hit.read_offset );
+    };
+    auto find_hits = [&]( unsigned int nof_threads ) {
+      std::vector< hit_type > hits;
+      if ( nof_threads == 1 ) {
+        TFineIndexIter< pathindex_type::index_type, seqan2::ParentLinks<> > piter( pindex.index );
+        TFineIndexIter< readsindex_type, seqan2::ParentLinks<> > riter( reads_index );
+        kmer_exact_matches( piter, riter, &pindex, &reads, k,
+                            [&]( Seed<> const& hit ) { hits.push_back( to_tuple( hit ) ); } );
+      }
+      else {
+        std::vector< std::vector< hit_type > > thits( nof_threads );
+        std::vector< std::function< void( Seed<> const& ) > > callbacks;
+        std::vector< std::function< void( std::size_t, bool ) > > collectors;
+        for ( unsigned int i = 0; i < nof_threads; ++i ) {
+          callbacks.push_back(
+              [&thits, &to_tuple, i]( Seed<> const& hit ) { thits[ i ].push_back( to_tuple( hit ) ); } );
+          collectors.push_back( []( std::size_t, bool ) { } );
+        }
+        kmer_exact_matches( pindex.index, reads_index, &pindex, &reads, k, callbacks, 0,
+                            collectors );
+        for ( auto const& th : thits ) hits.insert( hits.end(), th.begin(), th.end() );
+      }
+      std::sort( hits.begin(), hits.end() );
+      return hits;
+    };
+
+    auto truth = find_hits( 1 );
+
+    for ( unsigned int q : { 1, 3, 4, 8, 10 } ) {  // q = 10 is longer than the k-mers
+      WHEN( "The path index has a q-gram table with q = " + std::to_string( q ) )
+      {
+        pindex.create_qgram_table( q );
+        auto hits = find_hits( 1 );
+        auto phits = find_hits( 3 );
+
+        THEN( "It should find the same seeds as without the table" )
+        {
+          REQUIRE( !truth.empty() );
+          REQUIRE( pindex.index.get_qgram_table().get_q() == q );
+          REQUIRE( hits == truth );
+          REQUIRE( phits == truth );
+        }
+      }
+    }
+  }
+}
+
+SCENARIO( "Find seeds off paths using multiple threads", "[seedfinder]" )
+{
+  GIVEN ( "A small variation graph and a set of reads" )
+  {
+    typedef gum::SeqGraph< gum::Succinct > graph_type;
+    typedef SeedFinderTraits< gum::Succinct, Dna5QStringSet<>, seqan2::IndexWotd<> > finder_traits_type;
+    typedef SeedFinder< NoStats, finder_traits_type > finder_type;
+    typedef typename finder_type::traverser_type::output_type seed_type;
+    typedef std::tuple< std::size_t, std::size_t, std::size_t, std::size_t > hit_type;
+
+    finder_type::set_kokkos_handling_status( false );
+
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::load( graph, vgpath, vg_loader, true );
+
+    std::string readspath = test_data_dir + "/small/reads_n10l10e0i0.fastq";
+    seqan2::SeqFileIn reads_file;
+    if ( !open( reads_file, readspath.c_str() ) ) {
+      throw std::runtime_error( "cannot open file " + readspath );
+    }
+
+    unsigned int seed_len = 10;
+    finder_type finder( graph, seed_len );
+    finder.unset_as_finaliser();
+    finder.add_uncovered_loci( );
+
+    auto reads = finder.create_readrecord();
+    readRecords( reads, reads_file, 10 );
+
+    auto to_tuple = []( seed_type const& hit ) {
+      return std::make_tuple( hit.node_id, hit.node_offset, hit.read_id, hit.read_offset );
+    };
+
+    std::vector< hit_type > truth;
+    {
+      auto reads_index = finder.index_reads( reads );
+      auto traverser = finder.create_traverser();
+      finder.setup_traverser( traverser, reads, reads_index );
+      finder.seeds_off_paths(
+          traverser,
+          [&truth, &to_tuple]( seed_type const& hit ) { truth.push_back( to_tuple( hit ) ); } );
+      std::sort( truth.begin(), truth.end() );
+    }
+
+    for ( unsigned int nof_threads : { 2, 4, 7 } ) {
+      WHEN( "Traversing starting loci using " + std::to_string( nof_threads ) + " threads" )
+      {
+        std::vector< hit_type > hits;
+        std::mutex hits_lock;
+        auto reads_index = finder.index_reads( reads );
+        finder.seeds_off_paths(
+            reads, reads_index,
+            [&hits, &hits_lock, &to_tuple]( seed_type const& hit ) {
+              std::lock_guard< std::mutex > lock( hits_lock );
+              hits.push_back( to_tuple( hit ) );
+            },
+            nof_threads );
+        std::sort( hits.begin(), hits.end() );
+
+        THEN( "It should find the same seeds as the single-threaded traversal" )
+        {
+          REQUIRE( truth.size() == 10 );
+          REQUIRE( hits == truth );
+        }
+      }
+    }
+
+    WHEN( "Seeds are reported in batches to a sink shared by multiple threads" )
+    {
+      std::vector< hit_type > hits;
+      std::size_t nof_batches = 0;
+      std::mutex hits_lock;
+      auto reads_index = finder.index_reads( reads );
+      auto sink = make_seed_batch_sink< seed_type >(
+          [&]( seed_type const* seeds, std::size_t count ) {
+            std::lock_guard< std::mutex > lock( hits_lock );
+            for ( std::size_t i = 0; i < count; ++i ) hits.push_back( to_tuple( seeds[ i ] ) );
+            ++nof_batches;
+          },
+          3 );
+      finder.seeds_off_paths( reads, reads_index, sink, 4 );
+      std::sort( hits.begin(), hits.end() );
+
+      THEN( "All seeds should be passed to the sink" )
+      {
+        REQUIRE( hits == truth );
+        REQUIRE( nof_batches >= truth.size() / 3 );
+      }
+    }
+
+    WHEN( "Traversing starting loci on a snapshot of the graph" )
+    {
+      std::vector< hit_type > hits;
+      std::mutex hits_lock;
+      finder.create_graph_snapshot();
+      auto reads_index = finder.index_reads( reads );
+      finder.seeds_off_paths(
+          reads, reads_index,
+          [&hits, &hits_lock, &to_tuple]( seed_type const& hit ) {
+            std::lock_guard< std::mutex > lock( hits_lock );
+            hits.push_back( to_tuple( hit ) );
+          },
+          4 );
+      std::sort( hits.begin(), hits.end() );
+
+      THEN( "It should find the same seeds as the traversal on the graph" )
+      {
+        REQUIRE( !finder.get_graph_snapshot().empty() );
+        REQUIRE( hits == truth );
+      }
+    }
+  }
+}
+
+SCENARIO( "Find seeds off paths using the k-mer index of the starting loci", "[seedfinder]" )
+{
+  GIVEN ( "A small variation graph and a set of reads" )
+  {
+    typedef gum::SeqGraph< gum::Succinct > graph_type;
+    typedef SeedFinderTraits< gum::Succinct, Dna5QStringSet<>, seqan2::IndexWotd<> > finder_traits_type;
+    typedef SeedFinder< NoStats, finder_traits_type > finder_type;
+    typedef typename finder_type::traverser_type::output_type seed_type;
+    typedef std::tuple< std::size_t, std::size_t, std::size_t, std::size_t > hit_type;
+
+    finder_type::set_kokkos_handling_status( false );
+
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::load( graph, vgpath, vg_loader, true );
+
+    std::string readspath = test_data_dir + "/small/reads_n10l10e0i0.fastq";
+    seqan2::SeqFileIn reads_file;
+    if ( !open( reads_file, readspath.c_str() ) ) {
+      throw std::runtime_error( "cannot open file " + readspath );
+    }
+
+    unsigned int seed_len = 6;
+    finder_type finder( graph, seed_len );
+    finder.unset_as_finaliser();
+    finder.add_uncovered_loci( );
+
+    auto reads = finder.create_readrecord();
+    readRecords( reads, reads_file, 10 );
+    auto seeds = finder.create_readrecord();
+    finder.get_seeds( seeds, reads, 1 );
+
+    auto to_tuple = []( seed_type const& hit ) {
+      return std::make_tuple( hit.node_id, hit.node_offset, hit.read_id, hit.read_offset );
+    };
+    auto find_hits = [&]( unsigned int nof_threads ) {
+      std::vector< hit_type > hits;
+      std::mutex hits_lock;
+      auto seeds_index = finder.index_reads( seeds );
+      finder.seeds_off_paths(
+          seeds, seeds_index,
+          [&hits, &hits_lock, &to_tuple]( seed_type const& hit ) {
+            std::lock_guard< std::mutex > lock( hits_lock );
+            hits.push_back( to_tuple( hit ) );
+          },
+          nof_threads );
+      std::sort( hits.begin(), hits.end() );
+      hits.erase( std::unique( hits.begin(), hits.end() ), hits.end() );
+      return hits;
+    };
+
+    auto truth = find_hits( 1 );
+    finder.create_loci_index();
+
+    for ( unsigned int nof_threads : { 1, 4 } ) {
+      WHEN( "Matching the starting loci index using " + std::to_string( nof_threads ) + " threads" )
+      {
+        auto hits = find_hits( nof_threads );
+
+        THEN( "It should find the same seeds as traversing from each locus" )
+        {
+          REQUIRE( !truth.empty() );
+          REQUIRE( hits == truth );
+        }
+      }
+    }
+  }
+}
+
+TEMPLATE_SCENARIO( "Find seeds using other types of seeds index", "[seedfinder]",
+                   ( CFMIndex ),
+                   ( KmerIndex<> ) )
+{
+  GIVEN ( "A small variation graph and a set of reads" )
+  {
+    typedef gum::SeqGraph< gum::Succinct > graph_type;
+    typedef SeedFinderTraits< gum::Succinct, Dna5QStringSet<>, seqan2::IndexWotd<> > wotd_traits_type;
+    typedef SeedFinderTraits< gum::Succinct, Dna5QStringSet<>, TestType > other_traits_type;
+    typedef SeedFinder< NoStats, wotd_traits_type > wotd_finder_type;
+    typedef SeedFinder< NoStats, other_traits_type > other_finder_type;
+    typedef typename wotd_finder_type::readsrecord_type readsrecord_type;
+    typedef std::tuple< std::size_t, std::size_t, std::size_t, std::size_t > hit_type;
+
+    wotd_finder_type::set_kokkos_handling_status( false );
+    other_finder_type::set_kokkos_handling_status( false );
+
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::load( graph, vgpath, vg_loader, true );
+
+    std::string readspath = test_data_dir + "/small/reads_n10l10e0i0.fastq";
+    seqan2::SeqFileIn reads_file;
+    if ( !open( reads_file, readspath.c_str() ) ) {
+      throw std::runtime_error( "cannot open file " + readspath );
+    }
+    readsrecord_type reads;
+    readRecords( reads, reads_file, 10 );
+
+    unsigned int seed_len = 6;
+    auto find_hits = [&]( auto& finder, bool on_paths ) {
+      std::vector< hit_type > hits;
+      auto callback = [&hits]( Seed<> const& hit ) {
+        hits.emplace_back( hit.node_id, hit.node_offset, hit.read_id, hit.read_offset );
+      };
+      readsrecord_type seeds;
+      finder.get_seeds( seeds, reads, 1 );
+      auto seeds_index = finder.index_reads( seeds );
+      if ( on_paths ) finder.seeds_on_paths( seeds, seeds_index, callback );
+      else {
+        auto traverser = finder.create_traverser();
+        finder.setup_traverser( traverser, seeds, seeds_index );
+        finder.seeds_off_paths( traverser, callback );
+      }
+      std::sort( hits.begin(), hits.end() );
+      return hits;
+    };
+
+    wotd_finder_type wotd_finder( graph, seed_len );
+    wotd_finder.unset_as_finaliser();
+    other_finder_type other_finder( graph, seed_len );
+    other_finder.unset_as_finaliser();
+
+    WHEN( "Traversing the graph from all loci" )
+    {
+      wotd_finder.add_uncovered_loci( );
+      other_finder.add_uncovered_loci( );
+      auto truth = find_hits( wotd_finder, false );
+      auto hits = find_hits( other_finder, false );
+
+      THEN( "It should find the same seeds as using a suffix tree of the seeds" )
+      {
+        REQUIRE( !truth.empty() );
+        REQUIRE( hits == truth );
+      }
+    }
+
+    WHEN( "Finding seeds on paths" )
+    {
+      wotd_finder.pick_paths( 2, false );
+      wotd_finder.index_paths();
+      other_finder.pick_paths( 2, false );
+      other_finder.index_paths();
+      auto truth = find_hits( wotd_finder, true );
+      auto hits = find_hits( other_finder, true );
+
+      THEN( "It should find the same seeds as using a suffix tree of the seeds" )
+      {
+        REQUIRE( !truth.empty() );
+        REQUIRE( hits == truth );
+      }
+    }
   }
 }
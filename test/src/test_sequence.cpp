@@ -1269,6 +1269,94 @@ SCENARIO( "Increment a k-mer lexicographically", "[sequence]" )
   }
 }
 
+#ifdef __SIZEOF_INT128__
+typedef PackedKmer< uint128_type > WidePackedKmer;
+#else
+typedef PackedKmer<> WidePackedKmer;
+#endif
+
+TEMPLATE_SCENARIO( "Increment a packed k-mer lexicographically", "[sequence]",
+                   ( PackedKmer<> ),
+                   ( WidePackedKmer ) )
+{
+  typedef TestType kmer_type;
+
+  auto to_string = []( kmer_type const& kmer ) {
+    seqan2::DnaString str;
+    for ( std::size_t i = 0; i < length( kmer ); ++i ) appendValue( str, kmer[ i ] );
+    return str;
+  };
+
+  for ( unsigned int k : { 1u, 20u, static_cast< unsigned int >( kmer_type::CAPACITY ) } ) {
+    GIVEN( "A k-mer of length " + std::to_string( k ) + " with all 'A'" )
+    {
+      kmer_type kmer( k );
+
+      WHEN( "It is incremented" )
+      {
+        auto s = increment_kmer( kmer );
+        REQUIRE( s == k - 1 );
+        THEN( "It should be the next lexicographical kmer" )
+        {
+          REQUIRE( kmer.get_value() == 1 );
+          REQUIRE( kmer[ k - 1 ] == 'C' );
+        }
+      }
+
+      WHEN( "It is incremented at different positions" )
+      {
+        seqan2::DnaString str;
+        for ( unsigned int i = 0; i < k; ++i ) appendValue( str, 'A' );
+        std::size_t pos = k - 1;
+        bool matched = true;
+        for ( unsigned int i = 0; i < 1000 && pos + 1 != 0; ++i ) {
+          pos = ( i % 7 ) % k;
+          bool continuous = i % 3;
+          auto s1 = increment_kmer( str, pos, continuous );
+          auto s2 = increment_kmer( kmer, pos, continuous );
+          if ( s1 != s2 || to_string( kmer ) != str ) matched = false;
+          pos = s2;
+        }
+        THEN( "It should behave as incrementing the string" )
+        {
+          REQUIRE( matched );
+        }
+      }
+    }
+
+    GIVEN( "A k-mer of length " + std::to_string( k ) + " with all 'T'" )
+    {
+      kmer_type kmer( k );
+      for ( unsigned int i = 0; i < k; ++i ) kmer.set( i, 3 );
+
+      WHEN( "It is incremented" )
+      {
+        auto s = increment_kmer( kmer );
+        REQUIRE( s + 1 == 0 );
+        THEN( "It should be all 'A'" )
+        {
+          REQUIRE( kmer == kmer_type( k ) );
+        }
+      }
+    }
+
+    GIVEN( "A k-mer of length " + std::to_string( k ) + " with a prefix" )
+    {
+      kmer_type kmer( k );
+      assign_kmer_prefix( kmer, 0b1110, std::min( k, 2u ) );
+
+      THEN( "It should be the prefix followed by all 'A'" )
+      {
+        seqan2::DnaString str;
+        for ( unsigned int i = 0; i < k; ++i ) appendValue( str, 'T' );
+        assign_kmer_prefix( str, 0b1110, std::min( k, 2u ) );
+        REQUIRE( to_string( kmer ) == str );
+        REQUIRE( kmer[ 0 ] == ( k == 1 ? 'G' : 'T' ) );
+      }
+    }
+  }
+}
+
 SCENARIO( "Seeding", "[seeding][sequence]" )
 {
   unsigned int reads_num = 10;
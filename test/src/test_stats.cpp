@@ -18,6 +18,8 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <vector>
+#include <string>
 
 #include <psi/stats.hpp>
 
@@ -114,3 +116,38 @@ SCENARIO ( "Test the Timer", "[stats]" )
     }
   }
 }
+
+SCENARIO ( "Run timers concurrently", "[stats]" )
+{
+  GIVEN( "A number of threads each running its own wall clock timers" )
+  {
+    unsigned int nof_threads = 8;
+    unsigned int nof_rounds = 100;
+
+    WHEN( "They start and stop their timers at the same time" )
+    {
+      std::vector< std::thread > threads;
+      for ( unsigned int i = 0; i < nof_threads; ++i ) {
+        threads.emplace_back(
+            [i, nof_rounds]() {
+              for ( unsigned int r = 0; r < nof_rounds; ++r ) {
+                auto timer = Timer< SteadyClock >( "timer-concurrent-" + std::to_string( i ) );
+                std::this_thread::sleep_for( 100us );
+              }
+            } );
+      }
+      for ( auto& t : threads ) t.join();
+
+      THEN( "Each timer should get the accumulated duration of its own thread" )
+      {
+        for ( unsigned int i = 0; i < nof_threads; ++i ) {
+          auto name = "timer-concurrent-" + std::to_string( i );
+          auto d = Timer< SteadyClock >::get_duration_rep( name );
+          REQUIRE( static_cast< float >( d ) >= 100 * nof_rounds );
+          REQUIRE( Timer< SteadyClock >::get_period( name ).end
+                   >= Timer< SteadyClock >::get_period( name ).start );
+        }
+      }
+    }
+  }
+}
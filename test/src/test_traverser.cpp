@@ -18,6 +18,10 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <tuple>
+#include <map>
+#include <numeric>
+#include <algorithm>
 
 #include <gum/seqgraph.hpp>
 #include <gum/io_utils.hpp>
@@ -46,6 +50,42 @@ static const gum::ExternalLoader< vg::Graph > vg_loader { []( std::istream& in )
     return merged;
   } };
 
+/**
+ *  @brief  Minimum edit distance of a pattern to the graph walks starting from a locus.
+ *
+ *  Naive dynamic programming; `column` is the last column of the alignment and
+ *  `maxlen` is the maximum remaining length of the walk.
+ */
+template< typename TGraph >
+    unsigned int
+  naive_walk_distance( TGraph const& graph, typename TGraph::id_type id,
+      typename TGraph::offset_type offset, std::string const& pattern,
+      std::vector< unsigned int > column, unsigned int maxlen )
+{
+  unsigned int best = column.back();
+  std::string sequence = graph.node_sequence( id );
+  for ( ; offset < sequence.size() && maxlen > 0; ++offset, --maxlen ) {
+    std::vector< unsigned int > next( column.size() );
+    next[ 0 ] = column[ 0 ] + 1;
+    for ( std::size_t i = 1; i < column.size(); ++i ) {
+      unsigned int sub = column[ i - 1 ] +
+          ( sequence[ offset ] == 'N' || pattern[ i - 1 ] != sequence[ offset ] );
+      next[ i ] = std::min( { column[ i ] + 1, next[ i - 1 ] + 1, sub } );
+    }
+    column.swap( next );
+    best = std::min( best, column.back() );
+  }
+  if ( maxlen > 0 && offset == sequence.size() ) {
+    graph.for_each_edges_out(
+        id,
+        [&]( typename TGraph::id_type to, typename TGraph::linktype_type ) {
+          best = std::min( best, naive_walk_distance( graph, to, 0, pattern, column, maxlen ) );
+          return true;
+        } );
+  }
+  return best;
+}
+
 SCENARIO ( "Find reads in the graph using a Traverser (exact)", "[traverser]" )
 {
   typedef gum::SeqGraph< gum::Dynamic > graph_type;
@@ -144,3 +184,245 @@ SCENARIO ( "Find reads in the graph using a Traverser (exact)", "[traverser]" )
     }
   }
 }
+
+SCENARIO ( "Find reads in the graph using a Traverser (Hamming distance)", "[traverser]" )
+{
+  typedef gum::SeqGraph< gum::Dynamic > graph_type;
+  typedef graph_type::offset_type offset_type;
+
+  GIVEN ( "A small graph and a set of reads each with one substitution" )
+  {
+    typedef seqan2::IndexWotd<> TIndexSpec;
+    typedef seqan2::Index< Dna5QStringSet<>, TIndexSpec > TIndex;
+
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::extend( graph, vgpath, vg_loader, true );
+    std::string readspath = test_data_dir + "/small/reads_n10l10e0i0.fastq";
+    seqan2::SeqFileIn reads_file;
+    if ( !open( reads_file, readspath.c_str() ) ) {
+      throw std::runtime_error( "cannot open file " + readspath );
+    }
+
+    Records< Dna5QStringSet<> > reads;
+    readRecords( reads, reads_file, 10 );
+    for ( std::size_t r = 0; r < length( reads.str ); ++r ) {
+      auto ord = seqan2::ordValue( reads.str[ r ][ 5 ] );
+      reads.str[ r ][ 5 ] = seqan2::Dna5( ( ord + 1 ) % 4 );
+    }
+    TIndex reads_index( reads.str );
+
+    unsigned int seed_len = 10;
+    std::size_t truth[10][2] = { {1, 0}, {1, 1}, {9, 4}, {9, 17}, {16, 0}, {17, 0},
+      {20, 0}, {20, 31}, {20, 38}, {20, 38} };
+
+    typedef std::tuple< std::size_t, std::size_t, std::size_t, std::size_t, std::size_t > hit_type;
+    auto run_all = [&]( auto& traverser ) {
+      std::vector< hit_type > hits;
+      for ( std::size_t r = 1; r <= graph.get_node_count(); ++r ) {
+        const auto& node_id = graph.rank_to_id( r );
+        offset_type seqlen = graph.node_length( node_id );
+        for ( offset_type f = 0; f < seqlen; ++f ) {
+          traverser.add_locus( node_id, f );
+          traverser.run( [&hits]( Seed<> const& hit ) {
+                           hits.emplace_back( hit.node_id, hit.node_offset, hit.read_id,
+                                              hit.read_offset, hit.mismatches );
+                         } );
+        }
+      }
+      std::sort( hits.begin(), hits.end() );
+      return hits;
+    };
+
+    WHEN ( "Run BFS and DFS traversers allowing mismatches on all loci" )
+    {
+      typedef typename Traverser< graph_type, TIndex, BFS, ApproxMatching >::Type TBFSTraverser;
+      typedef typename Traverser< graph_type, TIndex, DFS, ApproxMatching >::Type TDFSTraverser;
+
+      TBFSTraverser bfs_traverser( &graph, &reads, &reads_index, seed_len );
+      TDFSTraverser dfs_traverser( &graph, &reads, &reads_index, seed_len );
+      auto bfs_hits = run_all( bfs_traverser );
+      auto dfs_hits = run_all( dfs_traverser );
+
+      THEN ( "It should find all reads with one mismatch at their original loci" )
+      {
+        for ( std::size_t r = 0; r < 10; ++r ) {
+          hit_type expected( truth[ r ][ 0 ], truth[ r ][ 1 ], r, 0, 1 );
+          REQUIRE( std::binary_search( bfs_hits.begin(), bfs_hits.end(), expected ) );
+        }
+        std::size_t max_mismatches = TBFSTraverser::max_mismatches;
+        for ( auto const& hit : bfs_hits ) {
+          REQUIRE( std::get< 4 >( hit ) <= max_mismatches );
+        }
+      }
+
+      AND_THEN ( "Both strategies should report the same hits" )
+      {
+        REQUIRE( bfs_hits == dfs_hits );
+      }
+    }
+
+    WHEN ( "Run BFS and DFS traversers on a snapshot of the graph" )
+    {
+      typedef typename Traverser< graph_type, TIndex, BFS, ApproxMatching >::Type TBFSTraverser;
+      typedef typename Traverser< graph_type, TIndex, DFS, ApproxMatching >::Type TDFSTraverser;
+
+      GraphSnapshot< graph_type > snapshot( graph );
+      TBFSTraverser bfs_traverser( &graph, &reads, &reads_index, seed_len );
+      TDFSTraverser dfs_traverser( &graph, &reads, &reads_index, seed_len );
+      auto bfs_hits = run_all( bfs_traverser );
+      auto dfs_hits = run_all( dfs_traverser );
+      bfs_traverser.set_snapshot_ptr( &snapshot );
+      dfs_traverser.set_snapshot_ptr( &snapshot );
+
+      THEN ( "They should report the same hits as on the graph" )
+      {
+        REQUIRE( run_all( bfs_traverser ) == bfs_hits );
+        REQUIRE( run_all( dfs_traverser ) == dfs_hits );
+      }
+    }
+  }
+}
+
+SCENARIO ( "Find reads in the graph using a Traverser (edit distance)", "[traverser]" )
+{
+  typedef gum::SeqGraph< gum::Dynamic > graph_type;
+  typedef graph_type::offset_type offset_type;
+
+  GIVEN ( "A small graph and a set of reads each with one insertion or deletion" )
+  {
+    typedef seqan2::IndexWotd<> TIndexSpec;
+    typedef seqan2::Index< Dna5QStringSet<>, TIndexSpec > TIndex;
+    typedef typename Traverser< graph_type, TIndex, DFS, EditMatching >::Type TTraverser;
+
+    std::string vgpath = test_data_dir + "/small/x.vg";
+    graph_type graph;
+    gum::util::extend( graph, vgpath, vg_loader, true );
+    std::string readspath = test_data_dir + "/small/reads_n10l10e0i0.fastq";
+    seqan2::SeqFileIn reads_file;
+    if ( !open( reads_file, readspath.c_str() ) ) {
+      throw std::runtime_error( "cannot open file " + readspath );
+    }
+
+    Records< Dna5QStringSet<> > reads;
+    readRecords( reads, reads_file, 10 );
+    for ( std::size_t r = 0; r < length( reads.str ); ++r ) {
+      if ( r % 2 == 0 ) erase( reads.str[ r ], 5 );
+      else insert( reads.str[ r ], 5, "T" );
+    }
+    TIndex reads_index( reads.str );
+
+    unsigned int seed_len = 10;
+    std::size_t truth[10][2] = { {1, 0}, {1, 1}, {9, 4}, {9, 17}, {16, 0}, {17, 0},
+      {20, 0}, {20, 31}, {20, 38}, {20, 38} };
+
+    WHEN ( "Run a DFS traverser allowing edits on all loci" )
+    {
+      TTraverser traverser( &graph, &reads, &reads_index, seed_len );
+      std::size_t max_errors = TTraverser::max_mismatches;
+
+      std::map< std::tuple< std::size_t, std::size_t, std::size_t >, std::size_t > hits;
+      for ( std::size_t r = 1; r <= graph.get_node_count(); ++r ) {
+        const auto& node_id = graph.rank_to_id( r );
+        offset_type seqlen = graph.node_length( node_id );
+        for ( offset_type f = 0; f < seqlen; ++f ) {
+          traverser.add_locus( node_id, f );
+          traverser.run( [&hits]( Seed<> const& hit ) {
+                           hits[ { hit.node_id, hit.node_offset, hit.read_id } ] = hit.mismatches;
+                         } );
+        }
+      }
+
+      THEN ( "It should find all reads at their original loci" )
+      {
+        for ( std::size_t r = 0; r < 10; ++r ) {
+          auto found = hits.find( { truth[ r ][ 0 ], truth[ r ][ 1 ], r } );
+          REQUIRE( found != hits.end() );
+          REQUIRE( found->second <= 1 );
+        }
+      }
+
+      AND_THEN ( "The hits should be exactly the loci within the edit distance" )
+      {
+        std::size_t nofhits = 0;
+        for ( std::size_t r = 1; r <= graph.get_node_count(); ++r ) {
+          const auto& node_id = graph.rank_to_id( r );
+          offset_type seqlen = graph.node_length( node_id );
+          for ( offset_type f = 0; f < seqlen; ++f ) {
+            for ( std::size_t i = 0; i < length( reads.str ); ++i ) {
+              seqan2::CharString read = reads.str[ i ];
+              std::string pattern( seqan2::toCString( read ) );
+              std::vector< unsigned int > column( pattern.size() + 1 );
+              std::iota( column.begin(), column.end(), 0 );
+              unsigned int dist = naive_walk_distance( graph, node_id, f, pattern, column,
+                                                       pattern.size() + max_errors );
+              auto found = hits.find( { node_id, f, i } );
+              if ( dist <= max_errors ) {
+                ++nofhits;
+                REQUIRE( found != hits.end() );
+                REQUIRE( found->second == dist );
+              }
+            }
+          }
+        }
+        REQUIRE( nofhits == hits.size() );
+      }
+    }
+
+    WHEN ( "Run a DFS traverser allowing edits on the seeds of the reads" )
+    {
+      unsigned int k = 8;
+      unsigned int step = 2;
+      Records< Dna5QStringSet<> > seeds;
+      seeding( seeds, reads, k, step );
+      TIndex seeds_index( seeds.str );
+      TTraverser traverser( &graph, &seeds, &seeds_index, k );
+      std::size_t max_errors = TTraverser::max_mismatches;
+
+      typedef std::tuple< std::size_t, std::size_t, std::size_t, std::size_t > key_type;
+      std::map< key_type, std::size_t > hits;
+      for ( std::size_t r = 1; r <= graph.get_node_count(); ++r ) {
+        const auto& node_id = graph.rank_to_id( r );
+        offset_type seqlen = graph.node_length( node_id );
+        for ( offset_type f = 0; f < seqlen; ++f ) {
+          traverser.add_locus( node_id, f );
+          traverser.run( [&hits]( Seed<> const& hit ) {
+                           key_type key = { hit.node_id, hit.node_offset, hit.read_id,
+                                            hit.read_offset };
+                           REQUIRE( hits.find( key ) == hits.end() );
+                           hits[ key ] = hit.mismatches;
+                         } );
+        }
+      }
+
+      THEN ( "The hits should report the read ID and offset of their seeds" )
+      {
+        std::size_t nofhits = 0;
+        for ( std::size_t r = 1; r <= graph.get_node_count(); ++r ) {
+          const auto& node_id = graph.rank_to_id( r );
+          offset_type seqlen = graph.node_length( node_id );
+          for ( offset_type f = 0; f < seqlen; ++f ) {
+            for ( std::size_t i = 0; i < length( reads.str ); ++i ) {
+              seqan2::CharString read = reads.str[ i ];
+              std::string sequence( seqan2::toCString( read ) );
+              for ( std::size_t o = 0; o + k <= sequence.size(); o += step ) {
+                std::string pattern = sequence.substr( o, k );
+                std::vector< unsigned int > column( pattern.size() + 1 );
+                std::iota( column.begin(), column.end(), 0 );
+                unsigned int dist = naive_walk_distance( graph, node_id, f, pattern, column,
+                                                         pattern.size() + max_errors );
+                auto found = hits.find( { node_id, f, i, o } );
+                if ( dist <= max_errors ) {
+                  ++nofhits;
+                  REQUIRE( found != hits.end() );
+                  REQUIRE( found->second == dist );
+                }
+              }
+            }
+          }
+        }
+        REQUIRE( nofhits == hits.size() );
+      }
+    }
+  }
+}
@@ -20,6 +20,8 @@
 #include <string>
 #include <vector>
 #include <iterator>
+#include <memory>
+#include <thread>
 
 #include <psi/utils.hpp>
 #include <sdsl/bit_vectors.hpp>
@@ -205,6 +207,74 @@ SCENARIO( "Rounding up to the next closest power of 2", "[utils]" )
   }
 }
 
+SCENARIO( "Load a vector from a memory mapped file", "[utils]" )
+{
+  std::string file_name_prefix = test_data_dir + "/test_mapped_";
+
+  GIVEN( "A file containing a serialized vector of integers" )
+  {
+    std::vector< uint32_t > v;
+    for ( uint32_t i = 0; i < 1000; ++i ) v.push_back( i * 3 );
+    std::string file_name = file_name_prefix + "1";
+    {
+      std::ofstream ofs( file_name, std::ofstream::out | std::ofstream::binary );
+      serialize( ofs, v );
+    }
+
+    WHEN( "It is read through a mapped input stream" )
+    {
+      MappedIStream ifs( file_name );
+      std::vector< uint32_t > w;
+      deserialize( ifs, w );
+
+      THEN( "It should be deserialized correctly" )
+      {
+        REQUIRE( ifs.get_file().size() == sizeof( DefaultContainerSize ) + 1000 * sizeof( uint32_t ) );
+        REQUIRE( w == v );
+        REQUIRE( is_bitwise_serializable< uint32_t >::value );
+        REQUIRE( !is_bitwise_serializable< std::pair< uint32_t, uint32_t > >::value );
+      }
+
+      AND_WHEN( "The stream is rewound and read element by element" )
+      {
+        ifs.clear();
+        ifs.seekg( 0 );
+        std::vector< uint32_t > u;
+        deserialize( ifs, u, std::back_inserter( u ) );
+
+        THEN( "The same vector should be read" )
+        {
+          REQUIRE( u == v );
+        }
+      }
+
+      AND_WHEN( "Reading passes the end of the file" )
+      {
+        uint32_t x;
+        ifs.read( reinterpret_cast< char* >( &x ), sizeof( x ) );
+
+        THEN( "The stream should fail" )
+        {
+          REQUIRE( !ifs );
+        }
+      }
+    }
+
+    std::remove( file_name.c_str() );
+  }
+
+  GIVEN( "A non-existent file" )
+  {
+    MappedIStream ifs( file_name_prefix + "nonexistent" );
+
+    THEN( "The stream should be in failed state" )
+    {
+      REQUIRE( !ifs );
+      REQUIRE( !ifs.get_file().is_open() );
+    }
+  }
+}
+
 SCENARIO( "Serialize and deserialize a vector", "[utils]" )
 {
   std::string file_name_prefix = test_data_dir + "/test_";
@@ -991,3 +1061,168 @@ SCENARIO( "Compute the average of a long stream of integers in parallel", "[util
     }
   }
 }
+
+SCENARIO( "Pass items between threads through a bounded queue", "[utils]" )
+{
+  GIVEN( "A bounded queue with capacity of two" )
+  {
+    BoundedQueue< std::unique_ptr< unsigned int > > queue( 2 );
+    unsigned int nof_items = 1000;
+
+    WHEN( "A producer pushes items while a consumer pops them" )
+    {
+      std::vector< unsigned int > popped;
+      std::thread producer(
+          [&queue, nof_items]() {
+            for ( unsigned int i = 0; i < nof_items; ++i ) {
+              queue.push( std::make_unique< unsigned int >( i ) );
+            }
+            queue.close();
+          } );
+      std::unique_ptr< unsigned int > item;
+      while ( queue.pop( item ) ) {
+        REQUIRE( queue.size() <= queue.get_capacity() );
+        popped.push_back( *item );
+      }
+      producer.join();
+
+      THEN( "All items should be popped in the same order" )
+      {
+        REQUIRE( popped.size() == nof_items );
+        for ( unsigned int i = 0; i < nof_items; ++i ) REQUIRE( popped[ i ] == i );
+      }
+    }
+
+    WHEN( "The queue is closed" )
+    {
+      queue.push( std::make_unique< unsigned int >( 7 ) );
+      queue.close();
+
+      THEN( "No item can be pushed but the remaining ones can be popped" )
+      {
+        std::unique_ptr< unsigned int > item;
+        REQUIRE( queue.is_closed() );
+        REQUIRE( !queue.push( std::make_unique< unsigned int >( 8 ) ) );
+        REQUIRE( queue.pop( item ) );
+        REQUIRE( *item == 7 );
+        REQUIRE( !queue.pop( item ) );
+      }
+    }
+  }
+}
+
+SCENARIO( "Keep a set of dense ids in a growable bitmap", "[utils]" )
+{
+  GIVEN( "Two empty bitmaps" )
+  {
+    IdBitmap first;
+    IdBitmap second( 10 );
+
+    WHEN( "Some ids out of their initial ranges are inserted" )
+    {
+      for ( std::size_t id : { 0, 3, 64, 65, 3, 700 } ) first.insert( id );
+      for ( std::size_t id : { 3, 5, 1300 } ) second.insert( id );
+
+      THEN( "The bitmaps should grow to contain them" )
+      {
+        REQUIRE( first.capacity() > 700 );
+        REQUIRE( first.count() == 5 );
+        REQUIRE( first.contains( 64 ) );
+        REQUIRE( !first.contains( 5 ) );
+        REQUIRE( !first.contains( 5000 ) );
+        REQUIRE( second.capacity() > 1300 );
+        REQUIRE( second.count() == 3 );
+      }
+
+      AND_WHEN( "They are merged" )
+      {
+        first |= second;
+
+        THEN( "The result should be the union of both sets" )
+        {
+          REQUIRE( first.count() == 7 );
+          for ( std::size_t id : { 0, 3, 5, 64, 65, 700, 1300 } ) {
+            REQUIRE( first.contains( id ) );
+          }
+        }
+      }
+
+      AND_WHEN( "One of them is cleared" )
+      {
+        auto capacity = first.capacity();
+        first.clear();
+
+        THEN( "It should be empty while keeping its capacity" )
+        {
+          REQUIRE( first.count() == 0 );
+          REQUIRE( first.capacity() == capacity );
+        }
+      }
+    }
+
+    WHEN( "A range is reserved" )
+    {
+      first.reserve( 1000 );
+
+      THEN( "It should have enough capacity without any id inserted" )
+      {
+        REQUIRE( first.capacity() >= 1000 );
+        REQUIRE( first.count() == 0 );
+      }
+    }
+  }
+
+  GIVEN( "Two shards covering the id ranges of two chunks" )
+  {
+    IdBitmap global;
+    IdBitmap first( 100, 100000 );
+    IdBitmap second;
+    second.rebase( 200100, 200300 );
+
+    WHEN( "The ids in their ranges are inserted" )
+    {
+      for ( std::size_t id : { 100000, 100001, 100099 } ) first.insert( id );
+      for ( std::size_t id : { 200100, 200299 } ) second.insert( id );
+
+      THEN( "They should only take their ranges" )
+      {
+        REQUIRE( first.get_offset() <= 100000 );
+        REQUIRE( first.capacity() < 200 );
+        REQUIRE( second.get_offset() <= 200100 );
+        REQUIRE( second.capacity() < 300 );
+        REQUIRE( first.count() == 3 );
+        REQUIRE( !first.contains( 99999 ) );
+      }
+
+      AND_WHEN( "They are merged into a global bitmap" )
+      {
+        global |= second;
+        global |= first;
+
+        THEN( "The result should be the union of both sets" )
+        {
+          REQUIRE( global.count() == 5 );
+          for ( std::size_t id : { 100000, 100001, 100099, 200100, 200299 } ) {
+            REQUIRE( global.contains( id ) );
+          }
+          REQUIRE( !global.contains( 0 ) );
+        }
+      }
+
+      AND_WHEN( "A shard is rebased to the next chunk" )
+      {
+        first.rebase( 100100, 100200 );
+        first.insert( 100150 );
+        first.insert( 50 );
+
+        THEN( "It should only contain the new ids" )
+        {
+          REQUIRE( first.count() == 2 );
+          REQUIRE( first.contains( 100150 ) );
+          REQUIRE( first.contains( 50 ) );
+          REQUIRE( !first.contains( 100000 ) );
+        }
+      }
+    }
+  }
+}